@@ -0,0 +1,39 @@
+#ifndef __CLIKIT_BENCH_HPP__
+#define __CLIKIT_BENCH_HPP__
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace bench {
+
+// keeps the optimizer from discarding results we never read
+template <typename T>
+void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// runs `fn` for `iters` iterations after a short warmup and
+// prints the mean time per iteration
+template <typename Fn>
+double run(const char* name, std::size_t iters, Fn&& fn) {
+    for (std::size_t i = 0; i < (iters / 10) + 1; i++) { fn(); }
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iters; i++) { fn(); }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / iters;
+    std::printf("%-40s %14.1f ns/iter  (%zu iters)\n", name, ns, iters);
+    return ns;
+}
+
+// iteration count, overridable with the first command line argument
+inline std::size_t iterations(int argc, const char** argv, std::size_t fallback) {
+    if (argc > 1) { return std::strtoull(argv[1], nullptr, 10); }
+    return fallback;
+}
+
+} // ns bench
+
+#endif
@@ -0,0 +1,45 @@
+// BitSet over a million args: counting and walking the unset bits when
+// almost all are set (a mostly consumed argv), half are, and few are.
+//
+//     bazel run -c opt //bench:bitset [-- ITERATIONS]
+
+#include "bench/bench.hpp"
+#include "src/clikit.hpp"
+
+static const std::size_t N = 1000000;
+
+int main(int argc, const char** argv) {
+    auto iters = bench::iterations(argc, argv, 200);
+
+    struct Pattern {
+        const char* remaining;
+        const char* walk;
+        std::size_t every; // one bit in `every` is left unset
+        bool invert;       // or set
+    };
+    const Pattern patterns[] = {
+        {"remaining(), 10 of 1M unset", "walk unset, 10 of 1M unset", N / 10, false},
+        {"remaining(), 1% unset", "walk unset, 1% unset", 100, false},
+        {"remaining(), half unset", "walk unset, half unset", 2, false},
+        {"remaining(), 99% unset", "walk unset, 99% unset", 100, true},
+    };
+
+    for (auto& p : patterns) {
+        cli::BitSet set(N);
+        for (std::size_t i = 0; i < N; i++) {
+            if (((i % p.every) == 0) == p.invert) { set.set(i); }
+        }
+
+        bench::run(p.remaining, iters, [&] {
+            bench::keep(set.remaining());
+        });
+
+        bench::run(p.walk, iters, [&] {
+            std::size_t sum = 0;
+            for (auto i = set.unset_begin(); i != set.unset_end(); ++i) { sum += *i; }
+            bench::keep(sum);
+        });
+    }
+
+    return 0;
+}
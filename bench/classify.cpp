@@ -0,0 +1,62 @@
+// Argv classification: the scalar per-arg ParseDesc constructor against
+// the single-pass SIMD scan, single and multi threaded, over a large
+// generated file list.
+//
+//     bazel run -c opt //bench:classify [-- ITERATIONS]
+
+#include <string>
+#include <vector>
+
+#include "bench/bench.hpp"
+#include "src/clikit.hpp"
+
+static const std::size_t ARGC = 500000;
+
+int main(int argc, const char** argv) {
+    auto iters = bench::iterations(argc, argv, 20);
+
+    std::vector<std::string> storage;
+    storage.reserve(ARGC);
+    for (std::size_t i = 0; i < ARGC; i++) {
+        if (i % 16 == 0) {
+            storage.push_back("--include=src/module_" + std::to_string(i) + "/include");
+        } else if (i % 16 == 1) {
+            storage.push_back("-v");
+        } else {
+            storage.push_back("build/objects/module_" + std::to_string(i / 16) + "/file_" + std::to_string(i) + ".o");
+        }
+    }
+    std::vector<const char*> args;
+    for (auto& s : storage) { args.push_back(s.c_str()); }
+
+    std::vector<cli::ParseDesc> desc;
+
+    bench::run("scalar ParseDesc + help match", iters, [&] {
+        desc.clear();
+        for (std::size_t i = 0; i < ARGC; i++) {
+            desc.emplace_back(args[i]);
+            if (not desc.back().is_positional()) {
+                desc.back().is_help = desc.back().matches(args[i], 'h')
+                    or desc.back().matches(args[i], "help");
+            }
+        }
+        bench::keep(desc.back().len);
+    });
+
+    bench::run("classify_args, 1 thread", iters, [&] {
+        cli::classify_args(ARGC, args.data(), 'h', "help", desc, 1);
+        bench::keep(desc.back().len);
+    });
+
+    bench::run("classify_args, auto threads", iters, [&] {
+        cli::classify_args(ARGC, args.data(), 'h', "help", desc);
+        bench::keep(desc.back().len);
+    });
+
+    bench::run("Context construction", iters, [&] {
+        cli::Context ctx(ARGC, args.data());
+        bench::keep(ctx.remaining());
+    });
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Answering a shell completion request for a tool with many subcommands,
+// each with a few dozen options: from the embedded completion specs, and
+// by running the Parser chain as programs without them do.
+//
+//     bazel run -c opt //bench:complete [-- ITERATIONS]
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "bench/bench.hpp"
+#include "src/clikit.hpp"
+
+static const std::size_t SUBCOMMANDS = 200;
+static const std::size_t OPTIONS = 30;
+
+static const char* ARGV[] = {
+    "tool", "--__complete", "5", "tool", "-v", "--jobs", "4", "sub-150", "--option-number-2",
+};
+static const std::size_t ARGC = sizeof(ARGV) / sizeof(ARGV[0]);
+
+int main(int argc, const char** argv) {
+    auto iters = bench::iterations(argc, argv, 10000);
+
+    std::vector<std::string> subs;
+    std::vector<std::string> options;
+    for (std::size_t i = 0; i < SUBCOMMANDS; i++) { subs.push_back("sub-" + std::to_string(i)); }
+    for (std::size_t i = 0; i < OPTIONS; i++) { options.push_back("option-number-" + std::to_string(i)); }
+
+    // the specs embed_help would generate, sorted by path
+    std::string top = "f-v\nf--verbose\nv--jobs\n";
+    for (auto& s : subs) { top += "c" + s + "\n"; }
+    std::string sub = top;
+    for (auto& o : options) { sub += "v--" + o + "\n"; }
+
+    std::vector<std::string> paths = {""};
+    for (auto& s : subs) { paths.push_back(" " + s); }
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<cli::EmbeddedHelp> table;
+    for (auto& p : paths) {
+        auto& spec = p.empty() ? top : sub;
+        cli::EmbeddedHelp e = {p.c_str(), "", 0, spec.data(), spec.size()};
+        table.push_back(e);
+    }
+
+    std::string out;
+    cli::embed_help(table.data(), table.size());
+    bench::run("embedded specs, 200 subcommands", iters, [&] {
+        cli::CompletionRequest req;
+        req.parse(ARGC, ARGV);
+        out.clear();
+        cli::complete(req, out);
+        bench::keep(out.size());
+    });
+    cli::embed_help(nullptr, 0);
+
+    bench::run("parser chain, 200 subcommands", iters, [&] {
+        bool verbose = false;
+        std::size_t jobs = 0;
+        const char* cmd = nullptr;
+        std::vector<std::string> values(OPTIONS);
+
+        cli::Parser parse(ARGC, ARGV);
+        parse.flag('v', "verbose", "verbose output", verbose)
+            .arg("jobs", "parallel jobs", jobs, "N");
+        for (auto& s : subs) {
+            parse.subcommand(s.c_str(), "one of many subcommands", cmd);
+            for (std::size_t i = 0; i < OPTIONS; i++) {
+                parse.arg(options[i].c_str(), "what this option does", values[i], "VALUE");
+            }
+            parse.done();
+        }
+        bench::keep(parse.wants_help());
+    });
+
+    std::printf("candidates: %s", out.c_str());
+    return 0;
+}
@@ -0,0 +1,122 @@
+// The rejection path of a batch validator, where about 30% of the command
+// lines are bad: catching the thrown ParseError against OnError::Stop,
+// which records the error and leaves formatting it to the caller, and
+// OnError::Collect, which carries on to find every error. Then finding
+// the "did you mean" suggestion for a mistyped flag among thousands.
+//
+//     bazel run -c opt //bench:errors [-- ITERATIONS]
+
+#include <string>
+#include <vector>
+
+#include "bench/bench.hpp"
+#include "src/clikit.hpp"
+
+static const std::size_t NUM_LINES = 10000;
+
+struct Job {
+    bool force = false;
+    std::uint32_t jobs = 1;
+    std::uint64_t memory = 0;
+    std::vector<std::string> tags;
+    const char* command = nullptr;
+};
+
+static void chain(cli::Parser& parse, Job& job) {
+    parse
+        .flag('f', "force", "submit even if a duplicate is queued", job.force)
+        .arg('j', "jobs", "parallel job count", job.jobs, "NUM")
+        .arg('m', "memory", "memory limit in MiB", job.memory, "MIB")
+        .list('t', "tag", "job tag", job.tags, "TAG")
+        .positional("command", "command to run", job.command, cli::ArgReq::Required);
+    parse.validate();
+}
+
+int main(int argc, const char** argv) {
+    auto iters = bench::iterations(argc, argv, 20);
+
+    // every third line or so fails in one of a few ways
+    static const char* GOOD[] = {"job", "-j", "8", "--memory=4096", "-t", "nightly", "--tag=retry", "run.sh"};
+    static const char* BAD_NUMBER[] = {"job", "-j", "eight", "--memory=4096", "-t", "nightly", "run.sh"};
+    static const char* BAD_FLAG[] = {"job", "-j", "8", "--memory=4096", "--tag=retry", "-f", "-f", "run.sh"};
+    static const char* MISSING[] = {"job", "-j", "8", "--memory=4096", "-t", "nightly", "--tag=retry"};
+    static const char* UNKNOWN[] = {"job", "-j", "8", "--memroy=4096", "-t", "nightly", "run.sh"};
+    struct Line { const char** argv; std::size_t argc; };
+    std::vector<Line> lines;
+    std::uint64_t x = 88172645463325252ull;
+    for (std::size_t i = 0; i < NUM_LINES; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        switch (x % 20) {
+        case 0: case 1: lines.push_back({BAD_NUMBER, sizeof(BAD_NUMBER) / sizeof(BAD_NUMBER[0])}); break;
+        case 2: lines.push_back({BAD_FLAG, sizeof(BAD_FLAG) / sizeof(BAD_FLAG[0])}); break;
+        case 3: case 4: lines.push_back({MISSING, sizeof(MISSING) / sizeof(MISSING[0])}); break;
+        case 5: lines.push_back({UNKNOWN, sizeof(UNKNOWN) / sizeof(UNKNOWN[0])}); break;
+        default: lines.push_back({GOOD, sizeof(GOOD) / sizeof(GOOD[0])}); break;
+        }
+    }
+
+    cli::Parser thrower(lines[0].argc, lines[0].argv);
+    bench::run("OnError::Throw, caught", iters, [&] {
+        std::size_t rejected = 0;
+        for (auto& l : lines) {
+            Job job;
+            try {
+                chain(thrower.reset(l.argc, l.argv), job);
+            } catch (const std::exception&) {
+                rejected++;
+            }
+        }
+        bench::keep(rejected);
+    });
+
+    cli::Parser stopper(lines[0].argc, lines[0].argv);
+    stopper.on_error(cli::OnError::Stop);
+    bench::run("OnError::Stop", iters, [&] {
+        std::size_t rejected = 0;
+        for (auto& l : lines) {
+            Job job;
+            chain(stopper.reset(l.argc, l.argv), job);
+            rejected += stopper.failed();
+        }
+        bench::keep(rejected);
+    });
+
+    cli::Parser collector(lines[0].argc, lines[0].argv);
+    collector.on_error(cli::OnError::Collect);
+    bench::run("OnError::Collect", iters, [&] {
+        std::size_t problems = 0;
+        for (auto& l : lines) {
+            Job job;
+            chain(collector.reset(l.argc, l.argv), job);
+            problems += collector.diagnostics().size();
+        }
+        bench::keep(problems);
+    });
+
+    // what a validator that reports every rejection pays in addition
+    bench::run("OnError::Stop, formatting messages", iters, [&] {
+        std::size_t length = 0;
+        for (auto& l : lines) {
+            Job job;
+            chain(stopper.reset(l.argc, l.argv), job);
+            if (stopper.failed()) {
+                length += stopper.error().message().size();
+            }
+        }
+        bench::keep(length);
+    });
+
+    // a tool with thousands of long flags, most of them near each other
+    std::vector<std::string> flags;
+    for (std::size_t i = 0; i < 4000; i++) { flags.push_back("option-number-" + std::to_string(i)); }
+    static const char TYPO[] = "optoin-number-1234";
+    bench::run("suggesting among 4000 long flags", iters * 100, [&] {
+        cli::NearestName nearest(TYPO, sizeof(TYPO) - 1);
+        for (auto& f : flags) {
+            nearest.consider(f.c_str());
+        }
+        bench::keep(nearest.best());
+    });
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Float conversion: std::stod/std::stof against cli::From, alone and
+// through list() over a large list of weights, converted in order and
+// with cli::parallel.
+//
+//     bazel run -c opt //bench:float [-- ITERATIONS]
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench/bench.hpp"
+#include "src/clikit.hpp"
+
+static const std::size_t NUM_WEIGHTS = 1000000;
+
+int main(int argc, const char** argv) {
+    auto iters = bench::iterations(argc, argv, 10);
+
+    // a mix of short thresholds and full precision weights
+    std::vector<std::string> weights;
+    weights.reserve(NUM_WEIGHTS);
+    std::uint64_t x = 88172645463325252ull;
+    char text[32];
+    for (std::size_t i = 0; i < NUM_WEIGHTS; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        double value = static_cast<double>(x >> 11) / (1ull << 53) * 1000.0;
+        snprintf(text, sizeof(text), "%.*g", static_cast<int>(3 + (x % 15)), value);
+        weights.push_back(text);
+    }
+
+    bench::run("std::stod", iters, [&] {
+        double sum = 0;
+        for (auto& w : weights) { sum += std::stod(w); }
+        bench::keep(sum);
+    });
+
+    bench::run("cli::From<double>", iters, [&] {
+        double sum = 0;
+        for (auto& w : weights) { sum += cli::From<double>(w.c_str()); }
+        bench::keep(sum);
+    });
+
+    bench::run("std::stof", iters, [&] {
+        float sum = 0;
+        for (auto& w : weights) { sum += std::stof(w); }
+        bench::keep(sum);
+    });
+
+    bench::run("cli::From<float>", iters, [&] {
+        float sum = 0;
+        for (auto& w : weights) { sum += cli::From<float>(w.c_str()); }
+        bench::keep(sum);
+    });
+
+    std::vector<const char*> args = {"weights"};
+    for (auto& w : weights) {
+        args.push_back("-w");
+        args.push_back(w.c_str());
+    }
+    bench::run("list() of double", iters, [&] {
+        std::vector<double> out;
+        cli::Parser parse(args.size(), args.data());
+        parse.list('w', "weights", out);
+        bench::keep(out.size());
+    });
+
+    bench::run("list() of double, parallel", iters, [&] {
+        std::vector<double> out;
+        cli::Parser parse(args.size(), args.data());
+        parse.list('w', "weights", cli::parallel(out));
+        bench::keep(out.size());
+    });
+
+    return 0;
+}
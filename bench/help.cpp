@@ -0,0 +1,94 @@
+// Rendering --help for a tool with many subcommands, each with a few
+// dozen options, the way tooling scraping every subcommand's help does.
+// Then registering and rendering one tool with thousands of options.
+//
+//     bazel run -c opt //bench:help [-- ITERATIONS]
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench/bench.hpp"
+#include "src/clikit.hpp"
+
+static const std::size_t SUBCOMMANDS = 200;
+static const std::size_t OPTIONS = 30;
+static const std::size_t BIG_GROUPS = 50;
+static const std::size_t BIG_OPTIONS = 5000;
+
+int main(int argc, const char** argv) {
+    auto iters = bench::iterations(argc, argv, 20);
+
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < OPTIONS; i++) {
+        names.push_back("option-number-" + std::to_string(i));
+    }
+
+    std::vector<cli::HelpMap> helps;
+    for (std::size_t s = 0; s < SUBCOMMANDS; s++) {
+        helps.emplace_back("tool", "a tool with many subcommands");
+        auto& h = helps.back();
+        h.subcommand_details("sub", "one of many subcommands", "A longer description of the subcommand.");
+        h.new_group("output", "where results go");
+        for (std::size_t i = 0; i < OPTIONS; i++) {
+            char short_flag = (i < 26) ? char('a' + i) : 0;
+            h.add_arg(i % 3 == 0, short_flag, names[i].c_str(), (i % 2) ? "VALUE" : "", "what this option does to the run");
+        }
+        h.add_positional(false, cli::ArgReq::Required, "input", "file to read");
+        h.add_variadic_positional("rest", "anything else");
+    }
+
+    std::size_t bytes = 0;
+    bench::run("print to std::ostream, 200 subcommands", iters, [&] {
+        std::ostringstream ss;
+        for (auto& h : helps) { h.print(ss); }
+        bytes = ss.tellp();
+        bench::keep(bytes);
+    });
+
+    std::string text;
+    bench::run("render to a string, 200 subcommands", iters, [&] {
+        for (auto& h : helps) { h.render(text); }
+        bench::keep(text.size());
+    });
+
+    int fd = open("/dev/null", O_WRONLY);
+    bench::run("write(2) to /dev/null, 200 subcommands", iters, [&] {
+        for (auto& h : helps) { h.write(fd); }
+    });
+    close(fd);
+
+    std::vector<std::string> big_names;
+    for (std::size_t i = 0; i < BIG_OPTIONS; i++) {
+        big_names.push_back("option-number-" + std::to_string(i));
+    }
+
+    auto fill_big = [&](cli::HelpMap& h) {
+        for (std::size_t i = 0; i < BIG_OPTIONS; i++) {
+            if (i % (BIG_OPTIONS / BIG_GROUPS) == 0) { h.new_group("group", "a group of options"); }
+            h.add_arg(true, 0, big_names[i].c_str(), (i % 2) ? "VALUE" : "", "what this option does to the run");
+        }
+    };
+
+    std::size_t big_bytes = 0;
+    bench::run("register 5000 options in 50 groups", iters, [&] {
+        cli::HelpMap h("tool", "a tool with many options");
+        fill_big(h);
+        big_bytes = h._strings.size();
+        bench::keep(big_bytes);
+    });
+
+    cli::HelpMap big("tool", "a tool with many options");
+    fill_big(big);
+    bench::run("render to a string, 5000 options", iters, [&] {
+        big.render(text);
+        bench::keep(text.size());
+    });
+
+    std::printf("%zu bytes of help per iteration\n", bytes);
+    std::printf("%zu bytes of interned text for 5000 options\n", big_bytes);
+    return 0;
+}
@@ -0,0 +1,58 @@
+// Integer conversion: the previous std::stoull path against
+// cli::From<std::uint64_t>, alone and through list() over a large id list,
+// both collected into a vector and streamed through a sink.
+//
+//     bazel run -c opt //bench:integer [-- ITERATIONS]
+
+#include <string>
+#include <vector>
+
+#include "bench/bench.hpp"
+#include "src/clikit.hpp"
+
+static const std::size_t NUM_IDS = 1000000;
+
+int main(int argc, const char** argv) {
+    auto iters = bench::iterations(argc, argv, 10);
+
+    std::vector<std::string> ids;
+    ids.reserve(NUM_IDS);
+    std::uint64_t x = 88172645463325252ull;
+    for (std::size_t i = 0; i < NUM_IDS; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        ids.push_back(std::to_string(x >> (i % 40)));
+    }
+
+    bench::run("std::stoull", iters, [&] {
+        std::uint64_t sum = 0;
+        for (auto& id : ids) { sum += std::stoull(id); }
+        bench::keep(sum);
+    });
+
+    bench::run("cli::From<std::uint64_t>", iters, [&] {
+        std::uint64_t sum = 0;
+        for (auto& id : ids) { sum += cli::From<std::uint64_t>(id.c_str()); }
+        bench::keep(sum);
+    });
+
+    std::vector<const char*> args = {"ids"};
+    for (auto& id : ids) {
+        args.push_back("--id");
+        args.push_back(id.c_str());
+    }
+    bench::run("list() of std::uint64_t", iters, [&] {
+        std::vector<std::uint64_t> out;
+        cli::Parser parse(args.size(), args.data());
+        parse.list("id", "ids", out);
+        bench::keep(out.size());
+    });
+
+    bench::run("list() into a sink", iters, [&] {
+        std::uint64_t sum = 0;
+        cli::Parser parse(args.size(), args.data());
+        parse.list("id", "ids", cli::sink<std::uint64_t>([&](std::uint64_t id) { sum += id; }));
+        bench::keep(sum);
+    });
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+// Typical small command lines: a BitSet sized for them alone, then building
+// a Context and running a short Parser chain over them from scratch.
+//
+//     bazel run -c opt //bench:small [-- ITERATIONS]
+
+#include <string>
+#include <vector>
+
+#include "bench/bench.hpp"
+#include "src/clikit.hpp"
+
+static const char* ARGV[] = {
+    "tool", "-v", "--jobs", "4", "--out=build", "-t", "a", "-t", "b", "main.cpp", "util.cpp",
+};
+static const std::size_t ARGC = sizeof(ARGV) / sizeof(ARGV[0]);
+
+int main(int argc, const char** argv) {
+    auto iters = bench::iterations(argc, argv, 1000000);
+
+    bench::run("BitSet(10), set and scan", iters, [] {
+        cli::BitSet set(10);
+        set.set(1);
+        set.set(4);
+        std::size_t sum = 0;
+        for (auto i = set.unset_begin(); i != set.unset_end(); ++i) { sum += *i; }
+        bench::keep(sum);
+    });
+
+    bench::run("BitSet(100), set and scan", iters, [] {
+        cli::BitSet set(100);
+        for (std::size_t i = 0; i < 100; i += 3) { set.set(i); }
+        bench::keep(set.remaining());
+    });
+
+    bench::run("Context, no arena", iters, [] {
+        cli::Context ctx(ARGC - 1, ARGV + 1);
+        bench::keep(ctx.remaining());
+    });
+
+    bench::run("Parser chain", iters, [] {
+        bool verbose = false;
+        int jobs = 0;
+        const char* out = nullptr;
+        std::vector<std::string> tags;
+        std::vector<const char*> files;
+
+        cli::Parser parse(ARGC, ARGV);
+        parse
+            .flag('v', "verbose", "test", verbose)
+            .arg('j', "jobs", "test", jobs)
+            .arg('o', "out", "test", out, "DIR")
+            .list('t', "tag", "test", tags)
+            .all_positionals("files", "test", files);
+        bench::keep(files.size());
+    });
+
+    return 0;
+}
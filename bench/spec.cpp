@@ -0,0 +1,93 @@
+// Per-parse cost of a compiled Spec against building a fresh Parser
+// for every command line.
+//
+//     bazel run -c opt //bench:spec [-- ITERATIONS]
+
+#include "bench/bench.hpp"
+#include "src/clikit.hpp"
+
+struct Options {
+    bool quiet = false;
+    bool dry_run = false;
+    bool force = false;
+    std::uint8_t verbosity = 0;
+    std::uint32_t jobs = 1;
+    std::uint64_t memory = 0;
+    std::string queue;
+    std::string user;
+    std::string workdir;
+    std::vector<std::string> env;
+    std::vector<std::string> tags;
+    const char* command = nullptr;
+    std::vector<const char*> args;
+};
+
+static const char* ARGV[] = {
+    "job", "-vv", "--jobs", "8", "--memory=4096", "--queue", "batch",
+    "-e", "HOME=/tmp", "-e", "PATH=/bin", "--tag=nightly", "--tag", "retry",
+    "--dry-run", "run.sh", "data.csv", "out.csv",
+};
+static const std::size_t ARGC = sizeof(ARGV) / sizeof(ARGV[0]);
+
+static void parse_chain(Options& opts) {
+    cli::Parser args(ARGC, ARGV);
+    args.details("job", "submit a job")
+        .flag('q', "quiet", "suppress output", opts.quiet)
+        .flag('n', "dry-run", "print instead of submitting", opts.dry_run)
+        .flag('f', "force", "submit even if a duplicate is queued", opts.force)
+        .count('v', "verbose", "increase verbosity level", opts.verbosity)
+        .arg('j', "jobs", "parallel job count", opts.jobs, "NUM")
+        .arg('m', "memory", "memory limit in MiB", opts.memory, "MIB")
+        .arg("queue", "queue to submit to", opts.queue, "NAME")
+        .arg('u', "user", "user to submit as", opts.user, "USER")
+        .arg('w', "workdir", "working directory", opts.workdir, "DIR")
+        .list('e', "env", "environment variable", opts.env, "KEY=VALUE")
+        .list('t', "tag", "job tag", opts.tags, "TAG")
+        .positional("command", "command to run", opts.command, cli::ArgReq::Required)
+        .all_positionals("args", "arguments to the command", opts.args);
+}
+
+static cli::Spec<Options> compile_spec() {
+    return cli::Spec<Options>::Builder()
+        .details("job", "submit a job")
+        .flag('q', "quiet", "suppress output", &Options::quiet)
+        .flag('n', "dry-run", "print instead of submitting", &Options::dry_run)
+        .flag('f', "force", "submit even if a duplicate is queued", &Options::force)
+        .count('v', "verbose", "increase verbosity level", &Options::verbosity)
+        .arg('j', "jobs", "parallel job count", &Options::jobs, "NUM")
+        .arg('m', "memory", "memory limit in MiB", &Options::memory, "MIB")
+        .arg("queue", "queue to submit to", &Options::queue, "NAME")
+        .arg('u', "user", "user to submit as", &Options::user, "USER")
+        .arg('w', "workdir", "working directory", &Options::workdir, "DIR")
+        .list('e', "env", "environment variable", &Options::env, "KEY=VALUE")
+        .list('t', "tag", "job tag", &Options::tags, "TAG")
+        .positional("command", "command to run", &Options::command, cli::ArgReq::Required)
+        .all_positionals("args", "arguments to the command", &Options::args)
+        .compile();
+}
+
+int main(int argc, const char** argv) {
+    auto iters = bench::iterations(argc, argv, 200000);
+
+    bench::run("fresh Parser per argv", iters, [] {
+        Options opts;
+        parse_chain(opts);
+        bench::keep(opts.jobs);
+    });
+
+    auto spec = compile_spec();
+    bench::run("Spec::parse, new Scratch", iters, [&] {
+        Options opts;
+        spec.parse(ARGC, ARGV, opts);
+        bench::keep(opts.jobs);
+    });
+
+    cli::Spec<Options>::Scratch scratch;
+    bench::run("Spec::parse, reused Scratch", iters, [&] {
+        Options opts;
+        spec.parse(ARGC, ARGV, opts, scratch);
+        bench::keep(opts.jobs);
+    });
+
+    return 0;
+}
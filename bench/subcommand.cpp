@@ -0,0 +1,69 @@
+// Dispatching on one of many subcommands: by chaining a subcommand() call
+// for each name, with and without lazy bodies, and by looking the arg up
+// in a Subcommands table.
+//
+//     bazel run -c opt //bench:subcommand [-- ITERATIONS]
+
+#include <string>
+#include <vector>
+
+#include "bench/bench.hpp"
+#include "src/clikit.hpp"
+
+static const std::size_t SUBCOMMANDS = 400;
+
+static const char* ARGV[] = {"tool", "sub-350", "--verbose"};
+static const std::size_t ARGC = sizeof(ARGV) / sizeof(ARGV[0]);
+
+// built at startup here, where a real tool would declare it constexpr
+static cli::SubcommandDesc DESCS[SUBCOMMANDS];
+
+int main(int argc, const char** argv) {
+    auto iters = bench::iterations(argc, argv, 100000);
+
+    std::vector<std::string> subs;
+    for (std::size_t i = 0; i < SUBCOMMANDS; i++) { subs.push_back("sub-" + std::to_string(i)); }
+    for (std::size_t i = 0; i < SUBCOMMANDS; i++) { DESCS[i] = {subs[i].c_str(), "one of many subcommands"}; }
+    static const auto table = cli::make_subcommands(DESCS);
+
+    bench::run("chained, 400 subcommands", iters, [&] {
+        bool verbose = false;
+        const char* cmd = nullptr;
+
+        cli::Parser parse(ARGC, ARGV);
+        for (auto& s : subs) {
+            parse.subcommand(s.c_str(), "one of many subcommands", cmd)
+                .flag('v', "verbose", "verbose output", verbose)
+                .done();
+        }
+        bench::keep(verbose);
+    });
+
+    bench::run("chained lazy, 400 subcommands", iters, [&] {
+        bool verbose = false;
+        const char* cmd = nullptr;
+
+        cli::Parser parse(ARGC, ARGV);
+        for (auto& s : subs) {
+            parse.subcommand(s.c_str(), "one of many subcommands", cmd, [&](cli::Parser& p) {
+                p.flag('v', "verbose", "verbose output", verbose);
+            });
+        }
+        bench::keep(verbose);
+    });
+
+    bench::run("table, 400 subcommands", iters, [&] {
+        bool verbose = false;
+        std::size_t cmd = table.npos;
+
+        cli::Parser parse(ARGC, ARGV);
+        parse.subcommand(table, cmd);
+        if (cmd != table.npos) {
+            parse.flag('v', "verbose", "verbose output", verbose);
+        }
+        parse.done();
+        bench::keep(verbose);
+    });
+
+    return 0;
+}
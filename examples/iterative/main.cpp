@@ -89,7 +89,8 @@ struct Options {
 
 cli::Parser parse_args(int argc, const char** argv, Options& opts) {
     cli::Parser args(argc, argv);
-    args.details(PROG_NAME, PROG_DESC_SHORT, PROG_DESC_LONG)
+    args.dynamic_help() // options come from other args, so help cannot be embedded
+        .details(PROG_NAME, PROG_DESC_SHORT, PROG_DESC_LONG)
         .version(PROG_VERS)
         .disable_help_shortcircuit()
         .count('v', "verbose", "increase verbosity level", opts.verbosity)
@@ -30,7 +30,7 @@ cli::Parser parse_args(int argc, const char** argv, Options& opts) {
     args.details(PROG_NAME, PROG_DESC_SHORT, PROG_DESC_LONG)
         .version(PROG_VERS)
         .count('v', "verbose", "increase verbosity level", opts.verbosity)
-        .arg('b', "block-size", "block size to read/write with", opts.block_size, "BYTES")
+        .arg('b', "block-size", "block size to read/write with (i.e. 4096, 64K, 1MiB)", opts.block_size, "BYTES")
         .flag("err", "print to stderr rather than stdout", opts.out_err)
         // require one, accept many
         .positional("file", "file to print out", opts.inputs, cli::ArgReq::Required)
@@ -72,6 +72,11 @@ void print(const std::string& fname, decltype(STDOUT_FILENO) outfd, std::size_t
 
 
 int main(int argc, const char** argv) {
+    // shell completion from the specs embedded at build time
+    if (cli::complete(argc, argv)) {
+        return 0;
+    }
+
     Options opts;
     try {
         auto args = parse_args(argc, argv, opts);
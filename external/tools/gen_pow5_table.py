@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+#
+# Generates src/clikit_pow5.inc, the 128 bit truncated powers of five used
+# by the Eisel-Lemire float parser in src/clikit.cpp.
+#
+#     python3 external/tools/gen_pow5_table.py > src/clikit_pow5.inc
+#
+# Each entry is 5^q for q in [SMALLEST, LARGEST] scaled by a power of two
+# so its most significant bit is set, as {high 64 bits, low 64 bits}.
+# Negative powers are reciprocals rounded up.
+
+SMALLEST = -342
+LARGEST = 308
+
+
+def entry(q):
+    if q >= 0:
+        power5 = 5 ** q
+        while power5 < (1 << 127):
+            power5 *= 2
+        while power5 >= (1 << 128):
+            power5 //= 2
+        return power5
+
+    power5 = 5 ** -q
+    z = 0
+    while (1 << z) < power5:
+        z += 1
+    if q >= -27:
+        return 2 ** (z + 127) // power5 + 1
+
+    c = 2 ** (2 * z + 2 * 64) // power5 + 1
+    while c >= (1 << 128):
+        c //= 2
+    return c
+
+
+def main():
+    print("// generated by external/tools/gen_pow5_table.py, do not edit")
+    print("//")
+    print("// 5^q for q in [{}, {}], normalized to 128 bits".format(SMALLEST, LARGEST))
+    for q in range(SMALLEST, LARGEST + 1):
+        c = entry(q)
+        print("{{0x{:016x}ull, 0x{:016x}ull}}, // 5^{}".format(c >> 64, c & ((1 << 64) - 1), q))
+
+
+if __name__ == "__main__":
+    main()
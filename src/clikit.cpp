@@ -1,7 +1,81 @@
 #include "src/clikit.hpp"
 
+#include <algorithm>
+#include <cfloat>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <locale.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace cli {
 
+//-------------------------------------------------------------------------
+// arena
+//-------------------------------------------------------------------------
+
+void Arena::grow(std::size_t min_size) {
+    auto size = std::max(min_size, _head ? (_head->size * 2) : _block_size);
+    auto block = static_cast<Block*>(::operator new(sizeof(Block) + size));
+    block->next = _head;
+    block->size = size;
+    _head = block;
+    _offset = 0;
+}
+
+void Arena::release() {
+    while (_head) {
+        auto next = _head->next;
+        ::operator delete(_head);
+        _head = next;
+    }
+    _offset = 0;
+}
+
+void* Arena::allocate(std::size_t n, std::size_t align) {
+    while (true) {
+        if (_head) {
+            auto base = reinterpret_cast<std::uintptr_t>(_head + 1);
+            auto at = (base + _offset + align - 1) & ~(std::uintptr_t(align) - 1);
+            if (at + n <= base + _head->size) {
+                _offset = at + n - base;
+                return reinterpret_cast<void*>(at);
+            }
+        }
+        grow(n + align);
+    }
+}
+
+void Arena::rewind() {
+    if (_head and _head->next) {
+        auto total = capacity();
+        release();
+        grow(total);
+    }
+    _offset = 0;
+}
+
+std::size_t Arena::capacity() const {
+    std::size_t total = 0;
+    for (auto b = _head; b; b = b->next) {
+        total += b->size;
+    }
+    return total;
+}
+
+
 //-------------------------------------------------------------------------
 // bitset
 //-------------------------------------------------------------------------
@@ -16,51 +90,133 @@ std::size_t BitSet::bit_index(std::size_t linear) const {
     return linear % BITS_PER_SIZET;
 }
 
+std::size_t BitSet::full_word(std::size_t word) const {
+    auto tail = bit_index(N);
+    if ((word + 1 == num_elements()) and tail) {
+        return ((std::size_t)(1) << tail) - 1;
+    }
+    return ~(std::size_t)(0);
+}
+std::size_t BitSet::next_open_word(std::size_t word) const {
+    auto words = num_elements();
+    auto idx = arr_index(word);
+    // summary bits past the last word are never set, so this stops there
+    std::size_t open = ~summary[idx] >> bit_index(word);
+    if (open) {
+        return std::min(words, word + __builtin_ctzll(open));
+    }
+    for (++idx; (idx * BITS_PER_SIZET) < words; ++idx) {
+        if (~summary[idx]) {
+            return std::min(words, idx * BITS_PER_SIZET + __builtin_ctzll(~summary[idx]));
+        }
+    }
+    return words;
+}
+
+const std::size_t BitSet::npos;
+
+BitSet::BitSet(BitSet&& o) noexcept
+    : N(o.N)
+    , count(o.count)
+    , data(std::move(o.data))
+    , summary_data(std::move(o.summary_data))
+{
+    adopt(o);
+}
+BitSet& BitSet::operator=(BitSet&& o) noexcept {
+    if (this != &o) {
+        N = o.N;
+        count = o.count;
+        data = std::move(o.data);
+        summary_data = std::move(o.summary_data);
+        adopt(o);
+    }
+    return *this;
+}
+
+void BitSet::adopt(BitSet& o) {
+    if (o.bits == o.small) {
+        std::copy(o.small, o.small + INLINE_WORDS, small);
+        bits = small;
+        small_summary = o.small_summary;
+        summary = &small_summary;
+    } else {
+        bits = data.data();
+        summary = summary_data.data();
+    }
+    o.N = 0;
+    o.count = 0;
+    o.bits = o.small;
+    o.summary = &o.small_summary;
+}
+
+void BitSet::reset(std::size_t n) {
+    N = n;
+    count = 0;
+    auto words = num_elements();
+    if (words <= INLINE_WORDS) {
+        std::fill(small, small + INLINE_WORDS, 0);
+        bits = small;
+        small_summary = 0;
+        summary = &small_summary;
+    } else {
+        data.assign(words, 0);
+        bits = data.data();
+        summary_data.assign(arr_index(words) + (bit_index(words) ? 1 : 0), 0);
+        summary = summary_data.data();
+    }
+}
+
 std::size_t BitSet::set(std::size_t linear) {
     auto arr = arr_index(linear);
     auto bit = bit_index(linear);
 
     if (linear >= N) {
-        #ifndef __EXCEPTIONS
-        return -1;
+        #if !CLIKIT_EXCEPTIONS
+        return npos;
         #else
         std::stringstream ss;
         ss << "linear index " << linear << " is out of the bitset bounds " << N;
         throw std::runtime_error(ss.str());
         #endif
     }
-    data[arr] |= (std::size_t)(1) << bit;
+    auto mask = (std::size_t)(1) << bit;
+    if (bits[arr] & mask) {
+        return linear;
+    }
+    bits[arr] |= mask;
+    count++;
+    if (bits[arr] == full_word(arr)) {
+        summary[arr_index(arr)] |= (std::size_t)(1) << bit_index(arr);
+    }
 
     return linear;
 }
 bool BitSet::is_set(std::size_t linear) {
     if (linear >= N) {
-        #ifndef __EXCEPTIONS
-        return -1;
+        #if !CLIKIT_EXCEPTIONS
+        return false;
         #else
         std::stringstream ss;
         ss << "linear index " << linear << " is out of the bitset bounds " << N;
         throw std::runtime_error(ss.str());
         #endif
     }
-    return data[arr_index(linear)] & ((std::size_t)(1) << bit_index(linear));
+    return bits[arr_index(linear)] & ((std::size_t)(1) << bit_index(linear));
 }
 void BitSet::unset(std::size_t linear) {
     if (not is_set(linear)) {
         return;
     }
-    data[arr_index(linear)] ^= (std::size_t)(1) << bit_index(linear);
+    auto arr = arr_index(linear);
+    bits[arr] ^= (std::size_t)(1) << bit_index(linear);
+    count--;
+    summary[arr_index(arr)] &= ~((std::size_t)(1) << bit_index(arr));
 }
 
 std::size_t BitSet::total() const { return N; }
-std::size_t BitSet::remaining() const { return total() - size(); }
-std::size_t BitSet::size() const {
-    std::size_t count = 0;
-    for (std::size_t i = 0; i < num_elements(); ++i) {
-        count += __builtin_popcountll(data[i]);
-    }
-    return count;
-}
+std::size_t BitSet::remaining() const { return N - count; }
+std::size_t BitSet::size() const { return count; }
 
 //
 // set_iterator
@@ -77,7 +233,7 @@ void BitSet::set_iterator::find_next_bit() {
         std::size_t idx = set->arr_index(cursor);
         std::size_t off = set->bit_index(cursor);
 
-        auto delta = __builtin_ffsll( set->data[idx] >> off );
+        auto delta = __builtin_ffsll( set->bits[idx] >> off );
         if (delta) {
             cursor += delta - 1; // -1 to account for initially added incr
             return;
@@ -105,9 +261,15 @@ void BitSet::unset_iterator::find_next_zero() {
         // get the index+offset to address into
         std::size_t index = set->arr_index(cursor);
         std::size_t offset = set->bit_index(cursor);
+
+        // jump over full words without loading them
+        if (set->summary[set->arr_index(index)] & ((std::size_t)(1) << set->bit_index(index))) {
+            cursor = std::min(set->total(), set->next_open_word(index) * BITS_PER_SIZET);
+            continue;
+        }
         // remove all the bits we've already considered, then logical not
         // since the 0s are now 1s we can just ffs like the other iter
-        std::size_t adjusted = ~(set->data[index] >> offset);
+        std::size_t adjusted = ~(set->bits[index] >> offset);
         std::size_t delta = __builtin_ffsll(adjusted);
 
         // if we see 63 bits, we've shifted the whole ptr[index]
@@ -132,12 +294,6 @@ void BitSet::unset_iterator::find_next_zero() {
 // generic helper functions
 //-------------------------------------------------------------------------
 
-bool is_valid_short(char c) {
-    return ((c >= '0' and c <= '9'))
-        or ((c >= 'a') and (c <= 'z'))
-        or ((c >= 'A') and (c <= 'Z'));
-}
-
 void arg_string(std::ostream& ss, char s, const char* l, bool pad) {
     bool valid_short = is_valid_short(s);
 
@@ -158,359 +314,2392 @@ std::string arg_string(char s, const char* l, bool pad) {
     return ss.str();
 }
 
+// incremental FNV-1a over a long name, so every prefix of a name can be
+// hashed in one pass. finish() mixes the low bits used for indexing
+static const std::uint64_t NAME_HASH_BASIS = 0xcbf29ce484222325ull;
+static std::uint64_t name_hash_step(std::uint64_t h, char c) {
+    return (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+}
+static std::uint64_t name_hash_finish(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
 
 
 //-------------------------------------------------------------------------
-// arg -> ctor delegation
+// errors
 //-------------------------------------------------------------------------
 
-// unsigned
-template<> std::uint8_t From<std::uint8_t>(const char* s) { return   std::stoul(s); }
-template<> std::uint16_t From<std::uint16_t>(const char* s) { return std::stoul(s); }
-template<> std::uint32_t From<std::uint32_t>(const char* s) { return std::stoul(s); }
-template<> std::uint64_t From<std::uint64_t>(const char* s) { return std::stoull(s); }
+const std::size_t Error::npos;
 
+// hints at the known name nearest `arg`, written as a flag if it was one
+static void did_you_mean(std::ostream& s, const char* arg, const char* suggestion) {
+    if (suggestion == nullptr) { return; }
+    s << " (did you mean '" << ((arg and (arg[0] == '-')) ? "--" : "") << suggestion << "'?)";
+}
 
-// signed
-template<> std::int8_t From<std::int8_t>(const char* s) { return   std::stol(s); }
-template<> std::int16_t From<std::int16_t>(const char* s) { return std::stol(s); }
-template<> std::int32_t From<std::int32_t>(const char* s) { return std::stol(s); }
-template<> std::int64_t From<std::int64_t>(const char* s) { return std::stoll(s); }
+void Error::message(std::ostream& s) const {
+    auto v = value ? value : "";
+    switch (code) {
+    case ErrorCode::None:
+        break;
+    case ErrorCode::Duplicate:
+        s << "argument '" << arg_string(short_flag, long_flag) << "' cannot be provided multiple times";
+        break;
+    case ErrorCode::DuplicateFlag:
+        s << "flag argument '" << arg_string(short_flag, long_flag) << "' provided more than once";
+        break;
+    case ErrorCode::Run:
+        s << "argument '" << short_flag << "' cannot be given in a run";
+        break;
+    case ErrorCode::MissingValue:
+        s << "no argument value provided to '" << arg_string(short_flag, long_flag) << "'";
+        break;
+    case ErrorCode::MissingListValue:
+        s << "no argument value provided to list '" << arg_string(short_flag, long_flag) << "'";
+        break;
+    case ErrorCode::UnexpectedValue:
+        s << "argument '" << arg_string(short_flag, long_flag) << "' does not take a value";
+        break;
+    case ErrorCode::UnknownArgument:
+        s << "unknown argument '" << v << "'";
+        did_you_mean(s, value, long_flag);
+        break;
+    case ErrorCode::Unused:
+        s << "unknown/unused argument(s):";
+        if (context) {
+            context->print_unused(s);
+        } else {
+            s << " " << v;
+            did_you_mean(s, value, long_flag);
+        }
+        break;
+    case ErrorCode::NotAvailable:
+        s << "argument '" << v << "' not available at this (sub)command";
+        break;
+    case ErrorCode::MissingArgument:
+        s << "missing argument: ";
+        arg_string(s, short_flag, long_flag, false);
+        break;
+    case ErrorCode::InvalidInteger:
+        s << "invalid integer '" << v << "'";
+        break;
+    case ErrorCode::IntegerOutOfRange:
+        s << "integer '" << v << "' is out of range";
+        break;
+    case ErrorCode::InvalidNumber:
+        s << "invalid number '" << v << "'";
+        break;
+    case ErrorCode::NumberOutOfRange:
+        s << "number '" << v << "' is out of range";
+        break;
+    case ErrorCode::ResponseFileUnreadable:
+        s << "could not read response file '" << v << "': " << strerror(sys_errno);
+        break;
+    case ErrorCode::ResponseFileNested:
+        s << "response file '" << v << "' is nested too deeply";
+        break;
+    case ErrorCode::ResponseFileQuote:
+        s << "unterminated quote in response file '" << v << "'";
+        break;
+    case ErrorCode::NestedGroup:
+        s << "nested groups are not allowed";
+        break;
+    case ErrorCode::ResponseFilesNeedScratch:
+        s << "response files need a Scratch to own their mappings";
+        break;
+    }
+}
 
+const std::uint32_t Diagnostics::NO_INDEX;
+
+void Diagnostics::add(const Error& e) {
+    Entry entry;
+    entry.index = (e.index == Error::npos) ? NO_INDEX : static_cast<std::uint32_t>(e.index);
+    entry.code = e.code;
+    entry.short_flag = e.short_flag;
+    entry.sys_errno = static_cast<std::int16_t>(e.sys_errno);
+    entry.long_flag = e.long_flag;
+    entry.value = e.value;
+    _entries.push_back(entry);
+}
 
-// floats
-template<> float From<float>(const char* s) { return std::stof(s); }
-template<> double From<double>(const char* s) { return std::stod(s); }
-template<> long double From<long double>(const char* s) { return std::stold(s); }
+Error Diagnostics::operator[](std::size_t i) const {
+    auto& entry = _entries[i];
+    Error e(
+        entry.code, (entry.index == NO_INDEX) ? Error::npos : entry.index,
+        entry.short_flag, entry.long_flag, entry.value
+    );
+    e.sys_errno = entry.sys_errno;
+    return e;
+}
+
+void Diagnostics::print(std::ostream& s) const {
+    for (std::size_t i = 0; i < size(); i++) {
+        (*this)[i].message(s);
+        s << "\n";
+    }
+}
 
+std::string Error::message() const {
+    std::stringstream ss;
+    message(ss);
+    return ss.str();
+}
 
+void Error::raise() const {
+#if CLIKIT_EXCEPTIONS
+    switch (code) {
+    case ErrorCode::MissingArgument:
+        throw MissingArgumentError(short_flag, long_flag);
+    case ErrorCode::NestedGroup:
+    case ErrorCode::ResponseFilesNeedScratch:
+        throw InternalError(message());
+    default:
+        throw ParseError(message());
+    }
+#else
+    std::cerr << "error: " << message() << std::endl;
+    std::abort();
+#endif
+}
 
 
 //-------------------------------------------------------------------------
-// help / printing descriptors
+// suggestions
 //-------------------------------------------------------------------------
 
+const std::size_t NearestName::MAX_LEN;
 
-// returns whether there are an args registered (including in groups)
-// but subcommands do not count as they are not args
-bool HelpMap::has_args() const {
-    if (not _args.empty()) { return true; }
-    if (not _pos.empty()) { return true; }
+NearestName::NearestName(const char* name, std::size_t len)
+    : _len(len)
+    , _bound(std::min<std::size_t>(3, std::max<std::size_t>(1, len / 3)))
+    , _best_distance(_bound + 1)
+{
+    memset(_eq, 0, sizeof(_eq));
+    if (len > MAX_LEN) { return; }
 
-    for (auto& g : _groups) {
-        if (not g.second.empty()) { return true; }
+    for (std::size_t i = 0; i < len; i++) {
+        _eq[static_cast<unsigned char>(name[i])] |= std::uint64_t(1) << i;
     }
-
-    return false;
 }
 
-void HelpMap::print_usage_args(std::ostream& ss) const {
-    std::vector<const ArgHelp*> required;
-    std::vector<const ArgHelp*> optional;
-
-    // sort into required and not
-    for (auto& g : _groups) {
-        for (auto& a : g.second) {
-            if (a.required()) {
-                required.emplace_back(&a);
-            } else {
-                optional.emplace_back(&a);
-            }
-        }
-    }
-    for (auto& a : _args) {
-        if (a.required()) {
-            required.emplace_back(&a);
-        } else {
-            optional.emplace_back(&a);
+std::size_t NearestName::distance(const char* candidate, std::size_t len, std::size_t limit) const {
+    auto too_far = limit + 1;
+    if ((_len == 0) or (_len > MAX_LEN)) { return too_far; }
+    if (((len > _len) ? (len - _len) : (_len - len)) > limit) { return too_far; }
+
+    // one column of the distance matrix per candidate character, each
+    // held as vertical deltas (+1 in vp, -1 in vn) over all of the name.
+    // the score tracks the bottom row, which can change by at most one
+    // per column left, so once it cannot come back under the bound we stop
+    auto last = std::uint64_t(1) << (_len - 1);
+    std::uint64_t vp = ~std::uint64_t(0);
+    std::uint64_t vn = 0;
+    std::uint64_t d0 = 0;
+    std::uint64_t prev_eq = 0;
+    std::size_t score = _len;
+
+    for (std::size_t j = 0; j < len; j++) {
+        auto eq = _eq[static_cast<unsigned char>(candidate[j])];
+        // diagonals continuing an adjacent transposition
+        auto tr = (((~d0) & eq) << 1) & prev_eq;
+        d0 = (((eq & vp) + vp) ^ vp) | eq | vn | tr;
+
+        auto hp = vn | ~(d0 | vp);
+        auto hn = vp & d0;
+        if (hp & last) {
+            score++;
+        } else if (hn & last) {
+            score--;
         }
+
+        // the top row is the candidate prefix length, so shift in a +1
+        hp = (hp << 1) | 1;
+        hn = hn << 1;
+        vp = hn | ~(d0 | hp);
+        vn = d0 & hp;
+        prev_eq = eq;
+
+        if (score > limit + (len - j - 1)) { return too_far; }
     }
 
-    // generate strings for each class
-    // TODO: this is gross... but the code to do it ad-hoc is even grosser imho
-    auto short_requireds = combine_all_shorts(required);
-    auto long_requireds = combine_all_nonshorts(required);
+    return score;
+}
 
-    auto short_optionals = combine_all_shorts(optional);
-    auto long_optionals = combine_all_nonshorts(optional);
+void NearestName::consider(const char* candidate) {
+    // nothing but the name itself is nearer than one edit
+    if (_best_distance == 1) { return; }
 
-    // print things to the stream
+    // only a nearer candidate is kept, so search no further than that
+    auto d = distance(candidate, strlen(candidate), _best_distance - 1);
+    if ((d == 0) or (d >= _best_distance)) { return; }
 
-    if (not short_requireds.empty()) {
-        ss << "-" << short_requireds;
-    }
-    if (not long_requireds.empty()) {
-        if (not short_requireds.empty()) {
-            ss << " ";
-        }
-        ss << long_requireds;
-    }
+    _best = candidate;
+    _best_distance = d;
+}
 
-    if (not optional.empty()) {
-        // do we need to separate from required's output
-        if (not required.empty()) {
-            ss << " ";
-        }
-        ss << "[";
+void parallel_for(
+    std::size_t n, std::size_t threads, std::size_t min_per_thread,
+    void (*fn)(void* ctx, std::size_t begin, std::size_t end), void* ctx
+) {
+    // too little to split, so skip asking for the core count (a syscall)
+    min_per_thread = std::max<std::size_t>(1, min_per_thread);
+    if ((threads == 1) or (n < 2 * min_per_thread)) {
+        fn(ctx, 0, n);
+        return;
     }
 
-    if (not short_optionals.empty()) {
-        ss << "-" << short_optionals;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
     }
-    if (not long_optionals.empty()) {
-        if (not short_optionals.empty()) {
-            ss << " ";
-        }
-        ss << long_optionals;
+    threads = std::min(threads, n / min_per_thread);
+
+    if (threads <= 1) {
+        fn(ctx, 0, n);
+        return;
     }
 
-    // close the bracket
-    if (not optional.empty()) {
-        ss << "]";
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    auto chunk = (n + threads - 1) / threads;
+    for (std::size_t t = 1; t < threads; t++) {
+        auto begin = std::min(n, t * chunk);
+        auto end = std::min(n, begin + chunk);
+        workers.emplace_back(fn, ctx, begin, end);
     }
+    fn(ctx, 0, std::min(n, chunk));
 
-    // print positionals
-    if (not required.empty() or not optional.empty()) {
-        ss << " ";
+    for (auto& w : workers) {
+        w.join();
     }
-    std::size_t pos_idx = 0;
-    for (auto& p : _pos) {
-        if (pos_idx) { ss << " "; }
+}
 
-        if (not p.required()) {
-            ss << "[";
-        }
 
-        ss << p.name;
-        if (p.variadic()) { ss << "..."; }
 
-        if (not p.required()) {
-            ss << "]";
-        }
-        pos_idx++;
-    }
-}
+//-------------------------------------------------------------------------
+// arg -> ctor delegation
+//-------------------------------------------------------------------------
 
-void HelpMap::details(const char* name, const char* desc, const char* long_desc) {
-    _desc = Description(name, desc, long_desc);
-}
-void HelpMap::subcommand_details(const char* name, const char* desc, const char* long_desc) {
-    _subcommand_desc = Description(name, desc, long_desc);
-    _subcommands += " ";
-    _subcommands += name;
+static int digit_value(char c) {
+    if ((c >= '0') and (c <= '9')) { return c - '0'; }
+    if ((c >= 'a') and (c <= 'z')) { return 10 + (c - 'a'); }
+    if ((c >= 'A') and (c <= 'Z')) { return 10 + (c - 'A'); }
+    return 36;
 }
 
-void HelpMap::clear_subcommands() {
-    _subs.clear();
-}
-void HelpMap::add_subcommand(const char* name, const char* desc) {
-    _subs.emplace_back(name, desc, "");
-    _longest_flag = std::max(_longest_flag, _subs.back().name_len + _indent_width);
-}
+// parses a size suffix at `s` into a multiplier, returning 0 if it is not one
+static std::uint64_t suffix_multiplier(const char* s) {
+    static const char UNITS[] = "KMGTPE";
+
+    char unit = (s[0] == 'k') ? 'K' : s[0];
+    auto found = strchr(UNITS, unit);
+    if ((unit == '\0') or (found == nullptr)) { return 0; }
+
+    std::uint64_t base = 1024;
+    s++;
+    if (s[0] == 'i') {
+        s++;
+        if (s[0] == 'B') { s++; }
+    } else if (s[0] == 'B') {
+        base = 1000;
+        s++;
+    }
+    if (s[0] != '\0') { return 0; }
 
-void HelpMap::new_group(const char* name, const char* desc) {
-    std::vector<ArgHelp> vec;
-    _groups.emplace_back(Description(name, desc, ""), vec);
+    std::uint64_t mult = 1;
+    for (auto i = UNITS; i <= found; i++) {
+        mult *= base;
+    }
+    return mult;
 }
 
-void HelpMap::print(std::ostream& s) const {
-    auto right_col_start =  _indent_width + _longest_flag + _indent_width;
-
-    bool in_subcommand = not _subcommands.empty();
+ConvertError parse_integer(
+    const char* s,
+    std::uint64_t max_positive, std::uint64_t max_negative,
+    std::uint64_t& magnitude, bool& negative
+) {
+    magnitude = 0;
+    negative = false;
 
-    // app leading line and usage
-    if (_desc.name_len) {
-        // leading line
-        s << _desc.name;
+    if (s == nullptr or s[0] == '\0') { return ConvertError::Empty; }
 
-        if (in_subcommand) {
-            s << _subcommands; // string includes a leading space
-        } else if (_app_version) {
-            s << " " << _app_version; // only print version when !subcommand
+    if ((s[0] == '+') or (s[0] == '-')) {
+        negative = (s[0] == '-');
+        s++;
+    }
+    auto limit = negative ? max_negative : max_positive;
+
+    unsigned base = 10;
+    if ((s[0] == '0') and (s[1] != '\0')) {
+        switch (s[1]) {
+        case 'x': case 'X': base = 16; s += 2; break;
+        case 'o': case 'O': base = 8; s += 2; break;
+        case 'b': case 'B': base = 2; s += 2; break;
+        default: break;
         }
+    }
 
-        if (_subcommand_desc.short_len) {
-            s << " - " << _subcommand_desc.short_desc;
-        } else if (_desc.short_len) {
-            s << " - " << _desc.short_desc;
+    // accumulate with 64 bit overflow checks, and against the
+    // (possibly narrower) limit once all digits are read
+    const char* digits = s;
+    bool overflow = false;
+    if (base == 10) {
+        for (unsigned d; (d = static_cast<unsigned char>(*s) - '0') < 10; s++) {
+            overflow |= __builtin_mul_overflow(magnitude, 10u, &magnitude);
+            overflow |= __builtin_add_overflow(magnitude, d, &magnitude);
         }
-        s << std::endl << std::endl;
+    } else {
+        for (int d; (d = digit_value(*s)) < (int)base; s++) {
+            overflow |= __builtin_mul_overflow(magnitude, base, &magnitude);
+            overflow |= __builtin_add_overflow(magnitude, d, &magnitude);
+        }
+    }
+    if (s == digits) { return ConvertError::Invalid; }
+    if (overflow or (magnitude > limit)) { return ConvertError::Overflow; }
+
+    if (*s != '\0') {
+        auto mult = suffix_multiplier(s);
+        if (mult == 0) { return ConvertError::Invalid; }
+        if (magnitude > limit / mult) { return ConvertError::Overflow; }
+        magnitude *= mult;
     }
 
+    return ConvertError::None;
+}
 
-    // usage
-    if (has_args()) {
-        s << "usage: " << _desc.name;
+template <typename T>
+static ErrorCode try_integer(const char* s, T& out) {
+    switch (parse_integer(s, out)) {
+    case ConvertError::None: return ErrorCode::None;
+    case ConvertError::Overflow: return ErrorCode::IntegerOutOfRange;
+    default: return ErrorCode::InvalidInteger;
+    }
+}
 
-        if (in_subcommand) {
-            s << _subcommands;
-        }
+template <typename T>
+static T convert_integer(const char* s) {
+    T out = 0;
+    auto err = try_integer(s, out);
+    if (err != ErrorCode::None) {
+        Error(err, Error::npos, 0, nullptr, s).raise();
+    }
+    return out;
+}
 
-        if (not _subs.empty()) {
-            s << " [cmd...]";
-        }
+// unsigned
+template<> std::uint8_t From<std::uint8_t>(const char* s) { return convert_integer<std::uint8_t>(s); }
+template<> std::uint16_t From<std::uint16_t>(const char* s) { return convert_integer<std::uint16_t>(s); }
+template<> std::uint32_t From<std::uint32_t>(const char* s) { return convert_integer<std::uint32_t>(s); }
+template<> std::uint64_t From<std::uint64_t>(const char* s) { return convert_integer<std::uint64_t>(s); }
 
-        s << " ";
 
-        print_usage_args(s);
-        s << std::endl << std::endl;
-    }
+// signed
+template<> std::int8_t From<std::int8_t>(const char* s) { return convert_integer<std::int8_t>(s); }
+template<> std::int16_t From<std::int16_t>(const char* s) { return convert_integer<std::int16_t>(s); }
+template<> std::int32_t From<std::int32_t>(const char* s) { return convert_integer<std::int32_t>(s); }
+template<> std::int64_t From<std::int64_t>(const char* s) { return convert_integer<std::int64_t>(s); }
 
-    // long description
-    if (_desc.long_len) {
-        if (_desc.long_len) {
-            s << _desc.long_desc << std::endl;
-        }
+// unsigned
+template<> ErrorCode TryFrom<std::uint8_t>(const char* s, std::uint8_t& out) { return try_integer(s, out); }
+template<> ErrorCode TryFrom<std::uint16_t>(const char* s, std::uint16_t& out) { return try_integer(s, out); }
+template<> ErrorCode TryFrom<std::uint32_t>(const char* s, std::uint32_t& out) { return try_integer(s, out); }
+template<> ErrorCode TryFrom<std::uint64_t>(const char* s, std::uint64_t& out) { return try_integer(s, out); }
 
-        s << std::endl;
+// signed
+template<> ErrorCode TryFrom<std::int8_t>(const char* s, std::int8_t& out) { return try_integer(s, out); }
+template<> ErrorCode TryFrom<std::int16_t>(const char* s, std::int16_t& out) { return try_integer(s, out); }
+template<> ErrorCode TryFrom<std::int32_t>(const char* s, std::int32_t& out) { return try_integer(s, out); }
+template<> ErrorCode TryFrom<std::int64_t>(const char* s, std::int64_t& out) { return try_integer(s, out); }
+
+
+// decimal -> binary floating point, after Eisel and Lemire's "Number
+// Parsing at a Gigabyte per Second" (the fast_float library)
+
+static const int POW5_SMALLEST = -342;
+static const std::uint64_t POW5_TABLE[][2] = {
+#include "src/clikit_pow5.inc"
+};
+
+template <typename T> struct FloatFormat;
+template <> struct FloatFormat<double> {
+    using Bits = std::uint64_t;
+    static const int MANTISSA_BITS = 52;
+    static const int MIN_EXPONENT = -1023;
+    static const int INFINITE_POWER = 0x7FF;
+    static const int MIN_ROUND_TO_EVEN = -4;
+    static const int MAX_ROUND_TO_EVEN = 23;
+    static const int SMALLEST_POW10 = -342;
+    static const int LARGEST_POW10 = 308;
+    static const int MAX_FAST_POW10 = 22;
+    static double exact_pow10(int e) {
+        static const double POW10[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        return POW10[e];
     }
-
-
-    // subcommands
-    if (_subs.size()) {
-        s << "subcommands:" << std::endl;
-        for (auto& sub : _subs) {
-            indent_stream(s, _indent_width);
-            s << sub.name;
-            indent_stream(s, right_col_start - _indent_width - sub.name_len);
-            s << sub.short_desc << std::endl;
-        }
-        s << std::endl;
+};
+template <> struct FloatFormat<float> {
+    using Bits = std::uint32_t;
+    static const int MANTISSA_BITS = 23;
+    static const int MIN_EXPONENT = -127;
+    static const int INFINITE_POWER = 0xFF;
+    static const int MIN_ROUND_TO_EVEN = -17;
+    static const int MAX_ROUND_TO_EVEN = 10;
+    static const int SMALLEST_POW10 = -65;
+    static const int LARGEST_POW10 = 38;
+    static const int MAX_FAST_POW10 = 10;
+    static float exact_pow10(int e) {
+        static const float POW10[] = {
+            1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+        };
+        return POW10[e];
     }
+};
+
+// the significand (at most 19 digits) and power of ten of a decimal number
+struct Decimal {
+    std::uint64_t mantissa;
+    std::int64_t exponent;
+    bool negative;
+    bool truncated; // non-zero digits beyond the 19th were dropped
+};
+
+static bool is_digit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
 
-    // groups
-    if (_groups.size()) {
-        for (auto& g : _groups) {
-            s << g.first.name << ": ";
-            indent_stream(s, right_col_start - g.first.name_len - 2);
-            s << g.first.short_desc << std::endl;
-            for (auto& a : g.second) {
-                indent_stream(s, _indent_width);
-                s << a.flags_string() << " " << a.arg_name;
-                indent_stream(s, right_col_start - _indent_width - a.left_col_width());
-                s << a.desc << std::endl;
-            }
-            s << std::endl;
-        }
+// case insensitive match of `word` at `s`
+static bool match_word(const char* s, const char* word) {
+    for (; *word; s++, word++) {
+        if ((*s | 0x20) != *word) { return false; }
     }
+    return true;
+}
 
-    // args
-    if (_args.size()) {
-        s << "options:" << std::endl;
-        for (auto& a : _args) {
-            indent_stream(s, _indent_width);
-            s << a.flags_string() << " " << a.arg_name;
-            indent_stream(s, right_col_start - _indent_width -  a.left_col_width());
-            s << a.desc << std::endl;
+// reads the decimal number at `s`, returning the first character past it
+// or nullptr if there are no digits
+static const char* scan_decimal(const char* s, Decimal& d) {
+    static const int MAX_DIGITS = 19;
+
+    d.mantissa = 0;
+    d.exponent = 0;
+    d.truncated = false;
+
+    bool any = false;
+    int digits = 0;
+    for (; is_digit(*s); s++) {
+        any = true;
+        unsigned c = *s - '0';
+        if (digits < MAX_DIGITS) {
+            d.mantissa = d.mantissa * 10 + c;
+            digits += (d.mantissa != 0);
+        } else {
+            d.exponent++;
+            d.truncated |= (c != 0);
         }
-        s << std::endl;
     }
-
-    // positionals
-    if (_pos.size()) {
-        s << "positionals:" << std::endl;
-        for (auto& p : _pos) {
-            indent_stream(s, _indent_width);
-            s << p.name;
-            if (p.variadic()) {
-                s << "...";
+    if (*s == '.') {
+        s++;
+        for (; is_digit(*s); s++) {
+            any = true;
+            unsigned c = *s - '0';
+            if (digits < MAX_DIGITS) {
+                d.mantissa = d.mantissa * 10 + c;
+                d.exponent--;
+                digits += (d.mantissa != 0);
+            } else {
+                d.truncated |= (c != 0);
             }
-            indent_stream(s, right_col_start - _indent_width - p.left_col_width());
-            if (not p.required()) {
-                s << "[optional] ";
+        }
+    }
+    if (not any) { return nullptr; }
+
+    // an 'e' without digits is not part of the number
+    if ((*s == 'e') or (*s == 'E')) {
+        auto e = s + 1;
+        bool negative = (*e == '-');
+        if ((*e == '-') or (*e == '+')) { e++; }
+        if (is_digit(*e)) {
+            std::int64_t value = 0;
+            for (; is_digit(*e); e++) {
+                // anything this large is already zero or infinity
+                if (value < 0x10000) { value = value * 10 + (*e - '0'); }
             }
-            s << p.desc << std::endl;
+            d.exponent += negative ? -value : value;
+            s = e;
         }
-        s << std::endl;
     }
+    return s;
+}
 
-    // pretty spacing
-    s << std::endl;
+struct Adjusted {
+    std::uint64_t mantissa;
+    int power2; // biased exponent
+    bool operator==(const Adjusted& o) const {
+        return (mantissa == o.mantissa) and (power2 == o.power2);
+    }
+};
+
+// 128 bit product of `w` and 5^q, only as precise as the top `BITS`
+// bits of the result require
+template <int BITS>
+static unsigned __int128 pow5_product(std::int64_t q, std::uint64_t w) {
+    static const std::uint64_t PRECISION_MASK = ~std::uint64_t(0) >> BITS;
+
+    auto& pow5 = POW5_TABLE[q - POW5_SMALLEST];
+    auto first = static_cast<unsigned __int128>(w) * pow5[0];
+    if ((static_cast<std::uint64_t>(first >> 64) & PRECISION_MASK) == PRECISION_MASK) {
+        auto second = static_cast<unsigned __int128>(w) * pow5[1];
+        first += second >> 64;
+    }
+    return first;
 }
 
+// w * 10^q rounded to nearest, ties to even
+template <typename T>
+static Adjusted eisel_lemire(std::int64_t q, std::uint64_t w) {
+    using F = FloatFormat<T>;
+
+    if ((w == 0) or (q < F::SMALLEST_POW10)) { return {0, 0}; }
+    if (q > F::LARGEST_POW10) { return {0, F::INFINITE_POWER}; }
+
+    int lz = __builtin_clzll(w);
+    w <<= lz;
+
+    auto product = pow5_product<F::MANTISSA_BITS + 3>(q, w);
+    auto high = static_cast<std::uint64_t>(product >> 64);
+    auto low = static_cast<std::uint64_t>(product);
+
+    int upper = static_cast<int>(high >> 63);
+    int shift = upper + 64 - F::MANTISSA_BITS - 3;
+
+    Adjusted am;
+    am.mantissa = high >> shift;
+    // floor(log2(10^q)) + 63, biased
+    am.power2 = static_cast<int>(((217706 * q) >> 16) + 63) + upper - lz - F::MIN_EXPONENT;
+
+    if (am.power2 <= 0) {
+        // subnormal
+        if (-am.power2 + 1 >= 64) { return {0, 0}; }
+        am.mantissa >>= -am.power2 + 1;
+        am.mantissa += (am.mantissa & 1);
+        am.mantissa >>= 1;
+        am.power2 = (am.mantissa < (std::uint64_t(1) << F::MANTISSA_BITS)) ? 0 : 1;
+        return am;
+    }
 
+    // exactly halfway between two floats, where rounding up would be wrong
+    if (
+        (low <= 1)
+        and (q >= F::MIN_ROUND_TO_EVEN) and (q <= F::MAX_ROUND_TO_EVEN)
+        and ((am.mantissa & 3) == 1)
+        and ((am.mantissa << shift) == high)
+    ) {
+        am.mantissa &= ~std::uint64_t(1);
+    }
 
-//-------------------------------------------------------------------------
-// parsing helpers
-//-------------------------------------------------------------------------
+    am.mantissa += (am.mantissa & 1);
+    am.mantissa >>= 1;
+    if (am.mantissa >= (std::uint64_t(2) << F::MANTISSA_BITS)) {
+        am.mantissa = std::uint64_t(1) << F::MANTISSA_BITS;
+        am.power2++;
+    }
+    am.mantissa &= ~(std::uint64_t(1) << F::MANTISSA_BITS);
 
+    if (am.power2 >= F::INFINITE_POWER) { return {0, F::INFINITE_POWER}; }
+    return am;
+}
 
-bool ParseDesc::is_positional() const {
-    return not (is_short or is_long);
+static locale_t c_locale() {
+    static locale_t loc = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+    return loc;
 }
 
-std::size_t ParseDesc::matches(const char* arg, char s) const {
-    if (not is_short) { return false; }
+static void strto(const char* s, char** end, float& out) { out = strtof_l(s, end, c_locale()); }
+static void strto(const char* s, char** end, double& out) { out = strtod_l(s, end, c_locale()); }
+static void strto(const char* s, char** end, long double& out) { out = strtold_l(s, end, c_locale()); }
 
-    std::size_t result = 0;
-    for (std::size_t i = 1; i < len; i++) {
-        if (arg[i] == s) {
-            result += 1;
-        }
+template <typename T>
+static ConvertError strto_float(const char* s, T& out, const char** end) {
+    // strtod skips leading whitespace, we do not
+    if ((s[0] == '\0') or isspace(static_cast<unsigned char>(s[0]))) {
+        return ConvertError::Invalid;
     }
 
-    return result;
-}
-
-bool ParseDesc::matches(const char* arg, const char* l) const {
-    if (not is_long or l == nullptr) { return false; }
+    T value;
+    char* stop = nullptr;
+    strto(s, &stop, value);
+    if (stop == s) { return ConvertError::Invalid; }
+    if (end) {
+        *end = stop;
+    } else if (*stop != '\0') {
+        return ConvertError::Invalid;
+    }
 
-    auto cmplen = eq_offset>0 ? eq_offset : len;
-    return strncmp(arg+2, l, cmplen-2) == 0;
+    auto p = s + ((s[0] == '-') or (s[0] == '+'));
+    if (std::isinf(value) and not match_word(p, "inf")) {
+        return ConvertError::Overflow;
+    }
+    out = value;
+    return ConvertError::None;
 }
 
+template <typename T>
+static ConvertError decimal_to_float(const char* s, T& out, const char** end) {
+    using F = FloatFormat<T>;
 
+    if (s == nullptr or s[0] == '\0') { return ConvertError::Empty; }
 
-//
-// parser
-//
+    auto p = s;
+    bool negative = (*p == '-');
+    if ((*p == '-') or (*p == '+')) { p++; }
 
+    if ((p[0] == '0') and ((p[1] | 0x20) == 'x')) {
+        return strto_float(s, out, end);
+    }
 
-Parser& Parser::done() {
-    // handle groups first -- does not add a level though so skip that
-    if (_in_group) {
-        _in_group = false;
-        return *this;
+    Decimal d;
+    auto stop = scan_decimal(p, d);
+    if (stop == nullptr) {
+        // special values
+        T value;
+        if (match_word(p, "infinity")) {
+            stop = p + 8;
+            value = std::numeric_limits<T>::infinity();
+        } else if (match_word(p, "inf")) {
+            stop = p + 3;
+            value = std::numeric_limits<T>::infinity();
+        } else if (match_word(p, "nan")) {
+            stop = p + 3;
+            value = std::numeric_limits<T>::quiet_NaN();
+        } else {
+            return ConvertError::Invalid;
+        }
+
+        if (end) {
+            *end = stop;
+        } else if (*stop != '\0') {
+            return ConvertError::Invalid;
+        }
+        out = negative ? -value : value;
+        return ConvertError::None;
     }
 
-    if (_level > 0) {
-        _level--;
+    if (end) {
+        *end = stop;
+    } else if (*stop != '\0') {
+        return ConvertError::Invalid;
     }
 
-    if (_level == (_ctx.level() - 1)) {
-        _ctx.end_chain();
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)
+    // Clinger's fast path: both operands are exact, so a single
+    // multiplication or division rounds correctly
+    if (
+        not d.truncated
+        and (d.exponent >= -F::MAX_FAST_POW10) and (d.exponent <= F::MAX_FAST_POW10)
+        and (d.mantissa <= (std::uint64_t(2) << F::MANTISSA_BITS))
+    ) {
+        T value = static_cast<T>(d.mantissa);
+        if (d.exponent < 0) {
+            value /= F::exact_pow10(-d.exponent);
+        } else {
+            value *= F::exact_pow10(d.exponent);
+        }
+        out = negative ? -value : value;
+        return ConvertError::None;
     }
+#endif
 
-    return *this;
+    auto am = eisel_lemire<T>(d.exponent, d.mantissa);
+    if (d.truncated and not (am == eisel_lemire<T>(d.exponent, d.mantissa + 1))) {
+        // the dropped digits decide the rounding, which needs every digit
+        return strto_float(s, out, end);
+    }
+    if (am.power2 == F::INFINITE_POWER) { return ConvertError::Overflow; }
+
+    typename F::Bits bits = static_cast<typename F::Bits>(
+        am.mantissa
+        | (static_cast<std::uint64_t>(am.power2) << F::MANTISSA_BITS)
+        | (static_cast<std::uint64_t>(negative) << (sizeof(T) * 8 - 1))
+    );
+    memcpy(&out, &bits, sizeof(out));
+    return ConvertError::None;
 }
 
-bool Parser::wants_help() const {
-    return _ctx.wants_help();
+ConvertError parse_float(const char* s, float& out, const char** end) {
+    return decimal_to_float(s, out, end);
+}
+ConvertError parse_float(const char* s, double& out, const char** end) {
+    return decimal_to_float(s, out, end);
+}
+ConvertError parse_float(const char* s, long double& out, const char** end) {
+    if (s == nullptr or s[0] == '\0') { return ConvertError::Empty; }
+    return strto_float(s, out, end);
 }
 
-void Parser::print() const {
-    if (not _ctx.wants_help()) {
-        return;
+template <typename T>
+static ErrorCode try_float(const char* s, T& out) {
+    T value = 0;
+    switch (parse_float(s, value)) {
+    case ConvertError::None: out = value; return ErrorCode::None;
+    case ConvertError::Overflow: return ErrorCode::NumberOutOfRange;
+    default: return ErrorCode::InvalidNumber;
     }
-
-    _help->print(std::cout);
 }
 
-// finalizer that asserts no unused arguments
-void Parser::validate() {
-    // if we are just printing help, don't validate
-    if (_ctx.wants_help()) {
-        return;
+template <typename T>
+static T convert_float(const char* s) {
+    T out = 0;
+    auto err = try_float(s, out);
+    if (err != ErrorCode::None) {
+        Error(err, Error::npos, 0, nullptr, s).raise();
     }
+    return out;
+}
 
-    if (_ctx.remaining()) {
-        std::stringstream ss;
-        ss << "unknown/unused argument(s):";
-        for (auto& a : _ctx) {
-            ss << " " << a.c_str;
-        }
-        throw ParseError(ss.str());
+// floats
+template<> float From<float>(const char* s) { return convert_float<float>(s); }
+template<> double From<double>(const char* s) { return convert_float<double>(s); }
+template<> long double From<long double>(const char* s) { return convert_float<long double>(s); }
+
+template<> ErrorCode TryFrom<float>(const char* s, float& out) { return try_float(s, out); }
+template<> ErrorCode TryFrom<double>(const char* s, double& out) { return try_float(s, out); }
+template<> ErrorCode TryFrom<long double>(const char* s, long double& out) { return try_float(s, out); }
+
+
+
+
+//-------------------------------------------------------------------------
+// help / printing descriptors
+//-------------------------------------------------------------------------
+
+//
+// string table
+//
+
+// a word at a time, help text is hashed whole rather than by prefix
+static std::uint32_t text_hash(const char* s, std::size_t n) {
+    std::uint64_t h = NAME_HASH_BASIS ^ n;
+    std::uint64_t w = 0;
+    for (; n >= 8; s += 8, n -= 8) {
+        memcpy(&w, s, 8);
+        h = name_hash_finish((h ^ w) * 0x100000001b3ull);
     }
+    w = 0;
+    memcpy(&w, s, n);
+    h = name_hash_finish((h ^ w) * 0x100000001b3ull);
+    return static_cast<std::uint32_t>(h >> 32);
+}
+
+TextRef StringTable::intern(const char* s, std::size_t n) {
+    auto begin = _text.size();
+    _text.append(s, n);
+    return commit(begin);
+}
+
+TextRef StringTable::add_flags(char s, const char* l) {
+    auto begin = _text.size();
+    bool valid_short = is_valid_short(s);
+    char lead[5] = {'-', s, '/', '-', '-'};
+    if (not valid_short) {
+        lead[0] = lead[1] = lead[2] = ' ';
+    }
+    _text.append(lead, (l != nullptr) ? 5 : 2);
+    if (l != nullptr) { _text.append(l); }
+
+    // each option has its own flags, nothing to share them with
+    TextRef added;
+    added.offset = static_cast<std::uint32_t>(begin);
+    added.len = static_cast<std::uint32_t>(_text.size() - begin);
+    return added;
+}
+
+TextRef StringTable::commit(std::size_t begin) {
+    TextRef added;
+    added.offset = static_cast<std::uint32_t>(begin);
+    added.len = static_cast<std::uint32_t>(_text.size() - begin);
+    if (added.len == 0) { return TextRef(); }
+
+    // keep at least half the slots empty
+    if ((_strings.size() + 1) * 2 > _slots.size()) { grow(); }
+
+    std::uint64_t hash = text_hash(data(added), added.len);
+    auto mask = _slots.size() - 1;
+    auto slot = hash & mask;
+    while (_slots[slot] != 0) {
+        if ((_slots[slot] >> 32) == hash) {
+            auto seen = _strings[(_slots[slot] & 0xffffffff) - 1];
+            if ((seen.len == added.len) and (memcmp(data(seen), data(added), added.len) == 0)) {
+                _text.resize(begin);
+                return seen;
+            }
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    _strings.push_back(added);
+    _slots[slot] = (hash << 32) | _strings.size();
+    return added;
+}
+
+void StringTable::grow() {
+    ArenaVector<std::uint64_t> slots(_slots.get_allocator());
+    slots.resize(std::max<std::size_t>(16, _slots.size() * 2), 0);
+
+    auto mask = slots.size() - 1;
+    for (auto s : _slots) {
+        if (s == 0) { continue; }
+        auto slot = (s >> 32) & mask;
+        while (slots[slot] != 0) { slot = (slot + 1) & mask; }
+        slots[slot] = s;
+    }
+    _slots.swap(slots);
+}
+
+//
+// registration
+//
+
+Description HelpMap::describe(const char* name, const char* desc, const char* long_desc) {
+    Description d;
+    d.name = _strings.intern(name);
+    d.short_desc = _strings.intern(desc);
+    d.long_desc = _strings.intern(long_desc);
+    return d;
+}
+
+void HelpMap::details(const char* name, const char* desc, const char* long_desc) {
+    _desc = describe(name, desc, long_desc);
+}
+void HelpMap::subcommand_details(const char* name, const char* desc, const char* long_desc) {
+    _subcommand_desc = describe(name, desc, long_desc);
+    _subcommands += " ";
+    _subcommands += name;
+}
+
+void HelpMap::clear_subcommands() {
+    _subs.clear();
+}
+void HelpMap::add_subcommand(const char* name, const char* desc) {
+    _subs.push_back(describe(name, desc, ""));
+    _longest_flag = std::max<std::size_t>(_longest_flag, _subs.back().name.len + _indent_width);
+}
+
+void HelpMap::new_group(const char* name, const char* desc) {
+    _groups.emplace_back(describe(name, desc, ""), ArenaVector<ArgHelp>(_args.get_allocator()));
+}
+
+void HelpMap::add_arg(
+    bool in_group, char s, const char* l,
+    const char* name, const char* desc, bool takes_value
+) {
+    ArgHelp a;
+    a.short_flag = s;
+    a.flags = _strings.add_flags(s, l);
+    a.arg_name = _strings.intern(name);
+    a.desc = _strings.intern(desc);
+    a.takes_value = takes_value;
+
+    if (in_group) {
+        _groups.back().second.push_back(a);
+        _longest_flag = std::max(
+            _longest_flag,
+            _indent_width + a.left_col_width() // extra indent
+        );
+    } else {
+        _args.push_back(a);
+        _longest_flag = std::max(_longest_flag, a.left_col_width());
+    }
+}
+
+void HelpMap::add_positional(bool variadic, ArgReq required, const char* name, const char* desc) {
+    PositionalHelp p;
+    p.name = _strings.intern(name);
+    p.desc = _strings.intern(desc);
+    p._is_variadic = variadic;
+    p._required = required == ArgReq::Required;
+
+    _pos.push_back(p);
+    _longest_flag = std::max(_longest_flag, p.left_col_width());
+}
+
+// returns whether there are an args registered (including in groups)
+// but subcommands do not count as they are not args
+bool HelpMap::has_args() const {
+    if (not _args.empty()) { return true; }
+    if (not _pos.empty()) { return true; }
+
+    for (auto& g : _groups) {
+        if (not g.second.empty()) { return true; }
+    }
+
+    return false;
+}
+
+//
+// rendering
+//
+
+// counts the bytes of the help text
+struct HelpMeasure {
+    std::size_t size = 0;
+
+    void put(char) { size++; }
+    void put(const char*, std::size_t n) { size += n; }
+    void pad(std::size_t n) { size += n; }
+};
+
+// formats the help text into a buffer already sized by HelpMeasure
+struct HelpBuffer {
+    char* out;
+
+    void put(char c) { *out++ = c; }
+    void put(const char* s, std::size_t n) {
+        memcpy(out, s, n);
+        out += n;
+    }
+    void pad(std::size_t n) {
+        memset(out, ' ', n);
+        out += n;
+    }
+};
+
+// spaces from column `at` to `column`, if not already past it
+template <typename Out>
+static void pad_to(Out& out, std::size_t at, std::size_t column) {
+    out.pad((column > at) ? column - at : 0);
+}
+
+// visits grouped then ungrouped args, in the order the usage line lists them
+template <typename Fn>
+static void each_arg_help(const HelpMap& h, Fn fn) {
+    for (auto& g : h._groups) {
+        for (auto& a : g.second) { fn(a); }
+    }
+    for (auto& a : h._args) { fn(a); }
+}
+
+template <typename Out>
+void HelpMap::render_usage_args(Out& out) const {
+    // required args then optional ones (in brackets), each class as its
+    // shorts combined into one "-abc" then its long only args
+    auto put = [&](TextRef r) { out.put(_strings.data(r), r.len); };
+
+    bool any[2] = {false, false};
+    bool shorts[2] = {false, false};
+    bool longs[2] = {false, false};
+    each_arg_help(*this, [&](const ArgHelp& a) {
+        auto opt = a.required() ? 0 : 1;
+        any[opt] = true;
+        (is_valid_short(a.short_flag) ? shorts : longs)[opt] = true;
+    });
+
+    for (int opt = 0; opt < 2; opt++) {
+        if (opt and any[opt]) {
+            // do we need to separate from required's output
+            if (any[0]) { out.put(' '); }
+            out.put('[');
+        }
+
+        if (shorts[opt]) {
+            out.put('-');
+            each_arg_help(*this, [&](const ArgHelp& a) {
+                if ((a.required() != bool(opt)) and is_valid_short(a.short_flag)) {
+                    out.put(a.short_flag);
+                }
+            });
+        }
+        if (longs[opt]) {
+            bool first = true;
+            each_arg_help(*this, [&](const ArgHelp& a) {
+                if ((a.required() == bool(opt)) or is_valid_short(a.short_flag)) {
+                    return;
+                }
+                if (shorts[opt] or not first) { out.put(' '); }
+                first = false;
+                out.put("--", 2);
+                put(a.long_flag());
+            });
+        }
+
+        // close the bracket
+        if (opt and any[opt]) {
+            out.put(']');
+        }
+    }
+
+    // positionals
+    if (any[0] or any[1]) {
+        out.put(' ');
+    }
+    std::size_t pos_idx = 0;
+    for (auto& p : _pos) {
+        if (pos_idx) { out.put(' '); }
+
+        if (not p.required()) { out.put('['); }
+        put(p.name);
+        if (p.variadic()) { out.put("...", 3); }
+        if (not p.required()) { out.put(']'); }
+        pos_idx++;
+    }
+}
+
+template <typename Out>
+void HelpMap::render(Out& out) const {
+    auto right_col_start =  _indent_width + _longest_flag + _indent_width;
+    auto put = [&](TextRef r) { out.put(_strings.data(r), r.len); };
+
+    bool in_subcommand = not _subcommands.empty();
+
+    // app leading line and usage
+    if (_desc.name.len) {
+        // leading line
+        put(_desc.name);
+
+        if (in_subcommand) {
+            out.put(_subcommands.data(), _subcommands.size()); // string includes a leading space
+        } else if (_app_version) {
+            out.put(' '); // only print version when !subcommand
+            out.put(_app_version, strlen(_app_version));
+        }
+
+        if (_subcommand_desc.short_desc.len) {
+            out.put(" - ", 3);
+            put(_subcommand_desc.short_desc);
+        } else if (_desc.short_desc.len) {
+            out.put(" - ", 3);
+            put(_desc.short_desc);
+        }
+        out.put("\n\n", 2);
+    }
+
+    // usage
+    if (has_args()) {
+        out.put("usage: ", 7);
+        put(_desc.name);
+
+        if (in_subcommand) {
+            out.put(_subcommands.data(), _subcommands.size());
+        }
+
+        if (not _subs.empty()) {
+            out.put(" [cmd...]", 9);
+        }
+
+        out.put(' ');
+
+        render_usage_args(out);
+        out.put("\n\n", 2);
+    }
+
+    // long description
+    if (_desc.long_desc.len) {
+        put(_desc.long_desc);
+        out.put("\n\n", 2);
+    }
+
+    // subcommands
+    if (_subs.size()) {
+        out.put("subcommands:\n", 13);
+        for (auto& sub : _subs) {
+            out.pad(_indent_width);
+            put(sub.name);
+            pad_to(out, _indent_width + sub.name.len, right_col_start);
+            put(sub.short_desc);
+            out.put('\n');
+        }
+        out.put('\n');
+    }
+
+    auto put_args = [&](const ArenaVector<ArgHelp>& args) {
+        for (auto& a : args) {
+            out.pad(_indent_width);
+            put(a.flags);
+            out.put(' ');
+            put(a.arg_name);
+            pad_to(out, _indent_width + a.left_col_width(), right_col_start);
+            put(a.desc);
+            out.put('\n');
+        }
+        out.put('\n');
+    };
+
+    // groups
+    for (auto& g : _groups) {
+        put(g.first.name);
+        out.put(": ", 2);
+        pad_to(out, g.first.name.len + 2, right_col_start);
+        put(g.first.short_desc);
+        out.put('\n');
+        put_args(g.second);
+    }
+
+    // args
+    if (_args.size()) {
+        out.put("options:\n", 9);
+        put_args(_args);
+    }
+
+    // positionals
+    if (_pos.size()) {
+        out.put("positionals:\n", 13);
+        for (auto& p : _pos) {
+            out.pad(_indent_width);
+            put(p.name);
+            if (p.variadic()) {
+                out.put("...", 3);
+            }
+            pad_to(out, _indent_width + p.left_col_width(), right_col_start);
+            if (not p.required()) {
+                out.put("[optional] ", 11);
+            }
+            put(p.desc);
+            out.put('\n');
+        }
+        out.put('\n');
+    }
+
+    // pretty spacing
+    out.put('\n');
+}
+
+void HelpMap::render(std::string& out) const {
+    HelpMeasure measure;
+    render(measure);
+
+    out.resize(measure.size);
+    HelpBuffer buffer{&out[0]};
+    render(buffer);
+}
+
+void HelpMap::print(std::ostream& s) const {
+    std::string text;
+    render(text);
+    s.write(text.data(), text.size());
+}
+
+// one write(2), unless it comes up short
+static bool write_all(int fd, const char* p, std::size_t left) {
+    while (left) {
+        auto n = ::write(fd, p, left);
+        if (n < 0) {
+            if (errno == EINTR) { continue; }
+            return false;
+        }
+        p += n;
+        left -= n;
+    }
+    return true;
+}
+
+bool HelpMap::write(int fd) const {
+    std::string text;
+    render(text);
+    return write_all(fd, text.data(), text.size());
+}
+
+
+//
+// embedded help
+//
+
+static const EmbeddedHelp* embedded_table = nullptr;
+static std::size_t embedded_size = 0;
+
+bool embed_help(const EmbeddedHelp* table, std::size_t n) {
+    embedded_table = table;
+    embedded_size = table ? n : 0;
+    return true;
+}
+
+const EmbeddedHelp* find_embedded_help(const char* path) {
+    auto end = embedded_table + embedded_size;
+    auto it = std::lower_bound(embedded_table, end, path, [](const EmbeddedHelp& e, const char* p) {
+        return strcmp(e.path, p) < 0;
+    });
+    if ((it != end) and (strcmp(it->path, path) == 0)) {
+        return it;
+    }
+    return nullptr;
+}
+
+
+//
+// completion
+//
+
+bool HelpMap::takes_value(const char* arg, std::size_t len) const {
+    bool found = false;
+    each_arg_help(*this, [&](const ArgHelp& a) {
+        if (found or not a.takes_value or (len < 2) or (arg[0] != '-')) {
+            return;
+        }
+        if ((len == 2) and is_valid_short(a.short_flag)) {
+            found = arg[1] == a.short_flag;
+            return;
+        }
+        auto l = a.long_flag();
+        found = (len == l.len + 2) and (arg[1] == '-') and (memcmp(arg + 2, text(l), l.len) == 0);
+    });
+    return found;
+}
+
+void HelpMap::completions(std::string& out, char help_short, const char* help_long) const {
+    for (auto& sub : _subs) {
+        out += 'c';
+        out.append(text(sub.name), sub.name.len);
+        out += '\n';
+    }
+
+    auto add = [&](char kind, char s, const char* l, std::size_t len) {
+        if (is_valid_short(s)) {
+            out += kind;
+            out += '-';
+            out += s;
+            out += '\n';
+        }
+        if (len) {
+            out += kind;
+            out += "--";
+            out.append(l, len);
+            out += '\n';
+        }
+    };
+    each_arg_help(*this, [&](const ArgHelp& a) {
+        auto l = a.long_flag();
+        add(a.takes_value ? 'v' : 'f', a.short_flag, text(l), l.len);
+    });
+    add('f', help_short, help_long, help_long ? strlen(help_long) : 0);
+}
+
+bool CompletionRequest::parse(std::size_t argc, const char** argv) {
+    if (argc < 2) {
+        return false;
+    }
+
+    if (strcmp(argv[1], COMPLETION_SCRIPT_FLAG) == 0) {
+        words = argv;
+        count = 1;
+        index = 0;
+        shell = (argc > 2) ? argv[2] : "";
+        return true;
+    }
+    if (strcmp(argv[1], COMPLETE_FLAG) != 0) {
+        return false;
+    }
+
+    std::uint64_t i = 0;
+    if ((argc < 3) or (TryFrom(argv[2], i) != ErrorCode::None)) {
+        i = 0; // completing the program name, so nothing to offer
+    }
+    words = argv + 3;
+    count = (argc > 3) ? argc - 3 : 0;
+    index = i;
+    shell = nullptr;
+    return true;
+}
+
+// calls `fn` with the kind and word of each line of a completion spec
+template <typename Fn>
+static void each_completion(StringView spec, Fn fn) {
+    auto p = spec.begin();
+    while (p < spec.end()) {
+        auto eol = static_cast<const char*>(memchr(p, '\n', spec.end() - p));
+        if (eol == nullptr) { eol = spec.end(); }
+        if (eol > p) {
+            fn(*p, StringView(p + 1, eol - p - 1));
+        }
+        p = eol + 1;
+    }
+}
+
+// the kind of `word` in `spec`, or 0 if it is not there
+static char completion_kind(StringView spec, StringView word) {
+    char kind = 0;
+    each_completion(spec, [&](char k, StringView w) {
+        if ((kind == 0) and (w == word)) { kind = k; }
+    });
+    return kind;
+}
+
+// the candidates for the current word of `req`, walking the words from
+// `from` with the spec at subcommand path `path`. `find` looks up the spec
+// of a deeper path, returning a null view for one it does not know
+template <typename Find>
+static void complete_words(const CompletionRequest& req, std::size_t from, std::string path, Find find, std::string& out) {
+    auto spec = find(path);
+    if (spec.data() == nullptr) {
+        return;
+    }
+
+    bool value_next = false;
+    bool subcommands_done = false;
+    auto last = std::min(req.index, req.count);
+    for (auto i = from; i < last; i++) {
+        StringView word(req.words[i]);
+        if (value_next) {
+            value_next = false;
+            continue;
+        }
+
+        if ((word.size() > 1) and (word[0] == '-')) {
+            value_next = completion_kind(spec, word) == 'v';
+            continue;
+        }
+
+        if (subcommands_done or (completion_kind(spec, word) != 'c')) {
+            // positionals end the subcommands
+            subcommands_done = true;
+            continue;
+        }
+        path += ' ';
+        path.append(word.data(), word.size());
+        spec = find(path);
+        if (spec.data() == nullptr) {
+            return;
+        }
+    }
+
+    if (value_next) {
+        return;
+    }
+
+    StringView current(req.current());
+    bool option = (current.size() > 0) and (current[0] == '-');
+    if (not option and subcommands_done) {
+        return;
+    }
+    each_completion(spec, [&](char kind, StringView word) {
+        // flags for an option, otherwise subcommands
+        if ((kind == 'c') == option) { return; }
+        if ((word.size() < current.size()) or (memcmp(word.data(), current.data(), current.size()) != 0)) {
+            return;
+        }
+        out.append(word.data(), word.size());
+        out += '\n';
+    });
+}
+
+bool complete(const CompletionRequest& req, std::string& out) {
+    if (req.shell) {
+        out = completion_script(req.shell, req.words[0]);
+        return true;
+    }
+
+    auto root = find_embedded_help("");
+    if ((root == nullptr) or (root->complete == nullptr)) {
+        return false;
+    }
+    complete_words(req, 1, "", [](const std::string& path) {
+        auto e = find_embedded_help(path.c_str());
+        if ((e == nullptr) or (e->complete == nullptr)) {
+            return StringView();
+        }
+        return StringView(e->complete, e->complete_size);
+    }, out);
+    return true;
+}
+
+bool complete(std::size_t argc, const char** argv) {
+    CompletionRequest req;
+    if (not req.parse(argc, argv)) {
+        return false;
+    }
+
+    std::string out;
+    if (not complete(req, out)) {
+        return false;
+    }
+    write_all(STDOUT_FILENO, out.data(), out.size());
+    return true;
+}
+
+static const char* const BASH_SCRIPT =
+    "_clikit_complete_{fn}() {\n"
+    "    local IFS=$'\\n'\n"
+    "    COMPREPLY=($(\"${COMP_WORDS[0]}\" --__complete \"$COMP_CWORD\" \"${COMP_WORDS[@]}\" 2>/dev/null))\n"
+    "}\n"
+    "complete -o default -F _clikit_complete_{fn} {prog}\n";
+
+static const char* const ZSH_SCRIPT =
+    "#compdef {prog}\n"
+    "_clikit_complete_{fn}() {\n"
+    "    local -a candidates\n"
+    "    candidates=(${(f)\"$(\"${words[1]}\" --__complete $((CURRENT - 1)) \"${words[@]}\" 2>/dev/null)\"})\n"
+    "    if (( ${#candidates} )); then\n"
+    "        compadd -- \"${candidates[@]}\"\n"
+    "    else\n"
+    "        _files\n"
+    "    fi\n"
+    "}\n"
+    "compdef _clikit_complete_{fn} {prog}\n";
+
+static const char* const FISH_SCRIPT =
+    "function __clikit_complete_{fn}\n"
+    "    set -l words (commandline -opc)\n"
+    "    set -l found ($words[1] --__complete (count $words) $words (commandline -ct) 2>/dev/null)\n"
+    "    if test (count $found) -eq 0\n"
+    "        __fish_complete_path (commandline -ct)\n"
+    "    else\n"
+    "        printf '%s\\n' $found\n"
+    "    end\n"
+    "end\n"
+    "complete -c {prog} -f -a '(__clikit_complete_{fn})'\n";
+
+std::string completion_script(const char* shell, const char* program) {
+    const char* script = nullptr;
+    if (strcmp(shell, "bash") == 0) {
+        script = BASH_SCRIPT;
+    } else if (strcmp(shell, "zsh") == 0) {
+        script = ZSH_SCRIPT;
+    } else if (strcmp(shell, "fish") == 0) {
+        script = FISH_SCRIPT;
+    } else {
+        return "";
+    }
+
+    // completing the command by its name, in functions named for it
+    auto name = strrchr(program, '/');
+    name = name ? name + 1 : program;
+    std::string ident(name);
+    for (auto& c : ident) {
+        if (not isalnum(static_cast<unsigned char>(c))) { c = '_'; }
+    }
+
+    std::string out;
+    for (auto p = script; *p; p++) {
+        if (strncmp(p, "{prog}", 6) == 0) {
+            out += name;
+            p += 5;
+        } else if (strncmp(p, "{fn}", 4) == 0) {
+            out += ident;
+            p += 3;
+        } else {
+            out += *p;
+        }
+    }
+    return out;
+}
+
+
+
+//-------------------------------------------------------------------------
+// parsing helpers
+//-------------------------------------------------------------------------
+
+
+bool ParseDesc::is_positional() const {
+    return not (is_short or is_long);
+}
+
+void ParseDesc::init_runs(const char* arg) {
+    if (is_long) {
+        runs_remaining = 1;
+        return;
+    }
+
+    runs_remaining = name_len();
+    for (std::size_t i = 1; i <= runs_remaining; i++) {
+        if (not is_valid_short(arg[i])) { continue; }
+
+        auto bit = (std::uint64_t)(1) << short_slot(arg[i]);
+        repeats |= shorts & bit;
+        shorts |= bit;
+    }
+}
+
+// the matching rules of ParseDesc, shared with ArgTable
+static std::size_t name_length(bool is_short, bool is_long, std::size_t len, std::size_t eq_offset) {
+    if (not (is_short or is_long)) { return len; }
+
+    auto end = eq_offset ? eq_offset : len;
+    return end - (is_long ? 2 : 1);
+}
+
+static std::size_t match_short(
+    const char* arg, char s,
+    std::uint64_t shorts, std::uint64_t repeats, std::size_t name_len
+) {
+    if (not is_valid_short(s)) { return 0; }
+
+    auto bit = (std::uint64_t)(1) << short_slot(s);
+    if (not (shorts & bit)) { return 0; }
+    if (not (repeats & bit)) { return 1; }
+
+    // only a flag repeated within the run needs counting.
+    // anything after an '=' separator is the value, not part of the run
+    std::size_t result = 0;
+    for (std::size_t i = 1; i <= name_len; i++) {
+        if (arg[i] == s) {
+            result += 1;
+        }
+    }
+
+    return result;
+}
+
+static bool match_long(const char* arg, const char* l, std::size_t len, std::size_t eq_offset) {
+    if (l == nullptr) { return false; }
+
+    auto cmplen = eq_offset>0 ? eq_offset : len;
+    return strncmp(arg+2, l, cmplen-2) == 0;
+}
+
+std::size_t ParseDesc::matches(const char* arg, char s) const {
+    if (not is_short) { return 0; }
+    return match_short(arg, s, shorts, repeats, name_len());
+}
+
+bool ParseDesc::matches(const char* arg, const char* l) const {
+    if (not is_long) { return false; }
+    return match_long(arg, l, len, eq_offset);
+}
+
+std::size_t ParseDesc::name_len() const {
+    return name_length(is_short, is_long, len, eq_offset);
+}
+
+
+//
+// arg table
+//
+
+const std::uint8_t ArgTable::SHORT;
+const std::uint8_t ArgTable::LONG;
+const std::uint8_t ArgTable::HELP;
+
+void ArgTable::resize(std::size_t n) {
+    _kind.resize(n);
+    _len.resize(n);
+    _eq_offset.resize(n);
+    _runs_remaining.resize(n);
+    _shorts.resize(n);
+    _repeats.resize(n);
+}
+
+void ArgTable::set(std::size_t i, const ParseDesc& d) {
+    _kind[i] = (d.is_short ? SHORT : 0) | (d.is_long ? LONG : 0) | (d.is_help ? HELP : 0);
+    _len[i] = d.len;
+    _eq_offset[i] = d.eq_offset;
+    _runs_remaining[i] = d.runs_remaining;
+    _shorts[i] = d.shorts;
+    _repeats[i] = d.repeats;
+}
+
+ParseDesc ArgTable::get(std::size_t i) const {
+    ParseDesc d;
+    d.is_short = _kind[i] & SHORT;
+    d.is_long = _kind[i] & LONG;
+    d.is_help = _kind[i] & HELP;
+    d.len = _len[i];
+    d.eq_offset = _eq_offset[i];
+    d.runs_remaining = _runs_remaining[i];
+    d.shorts = _shorts[i];
+    d.repeats = _repeats[i];
+    return d;
+}
+
+std::size_t ArgTable::matches(std::size_t i, const char* arg, char s) const {
+    if (not (_kind[i] & SHORT)) { return 0; }
+    return match_short(arg, s, _shorts[i], _repeats[i], name_len(i));
+}
+
+bool ArgTable::matches(std::size_t i, const char* arg, const char* l) const {
+    if (not (_kind[i] & LONG)) { return false; }
+    return match_long(arg, l, _len[i], _eq_offset[i]);
+}
+
+std::size_t ArgTable::name_len(std::size_t i) const {
+    return name_length(_kind[i] & SHORT, _kind[i] & LONG, _len[i], _eq_offset[i]);
+}
+
+std::size_t ArgTable::take_runs(std::size_t i, std::size_t n) {
+    _runs_remaining[i] -= std::min<std::size_t>(n, _runs_remaining[i]);
+    return _runs_remaining[i];
+}
+
+
+//
+// classification
+//
+
+#ifdef __SSE2__
+// Finds the length and first '=' of `arg` in one pass, 16 bytes at a time.
+// Loads are 16-byte aligned so they never cross into an unmapped page,
+// which means bytes before `arg` and past its terminator are read (but ignored).
+__attribute__((no_sanitize_address))
+static void scan_arg(const char* arg, std::size_t& len, std::size_t& first_eq) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i eq = _mm_set1_epi8('=');
+
+    auto misalign = reinterpret_cast<std::uintptr_t>(arg) & 15;
+    const char* block = arg - misalign;
+    unsigned valid = 0xFFFFu << misalign;
+
+    first_eq = 0;
+    for (;; block += 16, valid = 0xFFFFu) {
+        auto chunk = _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+        unsigned nul_bits = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero)) & valid;
+        unsigned eq_bits = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, eq)) & valid;
+
+        if (nul_bits) {
+            // only '=' before the terminator counts
+            eq_bits &= (1u << __builtin_ctz(nul_bits)) - 1;
+        }
+        if (eq_bits and not first_eq) {
+            first_eq = (block + __builtin_ctz(eq_bits)) - arg;
+        }
+        if (nul_bits) {
+            len = (block + __builtin_ctz(nul_bits)) - arg;
+            return;
+        }
+    }
+}
+#else
+static void scan_arg(const char* arg, std::size_t& len, std::size_t& first_eq) {
+    first_eq = 0;
+    for (len = 0; arg[len] != '\0'; len++) {
+        if ((arg[len] == '=') and not first_eq) {
+            first_eq = len;
+        }
+    }
+}
+#endif
+
+// calls `store(i, desc)` with the ParseDesc of each arg in [begin, end)
+template <typename Fn>
+static void classify_range(
+    std::size_t begin, std::size_t end, const char** argv,
+    char help_short, const char* help_long,
+    Fn store
+) {
+    for (std::size_t i = begin; i < end; i++) {
+        std::size_t len = 0;
+        std::size_t first_eq = 0;
+        scan_arg(argv[i], len, first_eq);
+
+        ParseDesc d(argv[i], len, first_eq);
+        if (not d.is_positional()) {
+            d.is_help = d.matches(argv[i], help_short) or d.matches(argv[i], help_long);
+        }
+        store(i, d);
+    }
+}
+
+void classify_args(
+    std::size_t argc, const char** argv,
+    char help_short, const char* help_long,
+    ParseDesc* desc,
+    std::size_t threads
+) {
+    // each thread only writes its own slice of `desc`
+    parallel_for(argc, threads, CLASSIFY_ARGS_PER_THREAD, [&](std::size_t begin, std::size_t end) {
+        classify_range(begin, end, argv, help_short, help_long, [&](std::size_t i, const ParseDesc& d) {
+            desc[i] = d;
+        });
+    });
+}
+
+void classify_args(
+    std::size_t argc, const char** argv,
+    char help_short, const char* help_long,
+    std::vector<ParseDesc>& desc,
+    std::size_t threads
+) {
+    desc.resize(argc);
+    classify_args(argc, argv, help_short, help_long, desc.data(), threads);
+}
+
+void classify_args(
+    std::size_t argc, const char** argv,
+    char help_short, const char* help_long,
+    ArgTable& table,
+    std::size_t threads
+) {
+    table.resize(argc);
+    parallel_for(argc, threads, CLASSIFY_ARGS_PER_THREAD, [&](std::size_t begin, std::size_t end) {
+        classify_range(begin, end, argv, help_short, help_long, [&](std::size_t i, const ParseDesc& d) {
+            table.set(i, d);
+        });
+    });
+}
+
+
+//
+// arg index
+//
+
+const ArgIndex::LongGroup* ArgIndex::find_group(
+    const char** argv, const ArgTable& args,
+    const char* l, std::size_t n, std::uint64_t h
+) const {
+    auto mask = _table.size() - 1;
+    for (auto slot = h & mask; _table[slot]; slot = (slot + 1) & mask) {
+        auto& group = _groups[_table[slot] - 1];
+        if (
+            (group.hash == h)
+            and (args.name_len(group.first) == n)
+            and (strncmp(argv[group.first] + 2, l, n) == 0)
+        ) {
+            return &group;
+        }
+    }
+    return nullptr;
+}
+
+void ArgIndex::grow_table() {
+    _table.assign(std::max<std::size_t>(64, _table.size() * 2), 0);
+
+    auto mask = _table.size() - 1;
+    for (std::size_t g = 0; g < _groups.size(); g++) {
+        auto slot = _groups[g].hash & mask;
+        while (_table[slot]) { slot = (slot + 1) & mask; }
+        _table[slot] = g + 1;
+    }
+}
+
+void ArgIndex::build(std::size_t argc, const char** argv, const ArgTable& args) {
+    std::fill(_short_offsets, _short_offsets + NUM_SHORTS + 1, 0);
+    _shorts.clear();
+    _groups.clear();
+    _table.assign(_table.empty() ? 64 : _table.size(), 0);
+    _group_of.clear();
+
+    // first pass sizes the short buckets and groups the longs by name
+    for (std::size_t i = 0; i < argc; i++) {
+        if (args.is_long(i) and args.name_len(i)) {
+            auto name = argv[i] + 2;
+            auto n = args.name_len(i);
+
+            auto h = NAME_HASH_BASIS;
+            for (std::size_t c = 0; c < n; c++) { h = name_hash_step(h, name[c]); }
+            h = name_hash_finish(h);
+
+            auto group = find_group(argv, args, name, n, h);
+            if (group == nullptr) {
+                // keep the table at most half full
+                if ((_groups.size() + 1) * 2 > _table.size()) {
+                    _groups.push_back({i, h, 0, 0});
+                    grow_table();
+                } else {
+                    _groups.push_back({i, h, 0, 0});
+                    auto mask = _table.size() - 1;
+                    auto slot = h & mask;
+                    while (_table[slot]) { slot = (slot + 1) & mask; }
+                    _table[slot] = _groups.size();
+                }
+                group = &_groups.back();
+            }
+            _group_of.push_back(group - _groups.data());
+            _groups[_group_of.back()].end++;
+        }
+        for (auto bits = args.shorts(i); bits; bits &= bits - 1) {
+            _short_offsets[__builtin_ctzll(bits) + 1]++;
+        }
+    }
+
+    for (std::size_t slot = 0; slot < NUM_SHORTS; slot++) {
+        _short_offsets[slot + 1] += _short_offsets[slot];
+    }
+
+    // groups' `end` holds their size until now
+    std::size_t offset = 0;
+    for (auto& g : _groups) {
+        g.begin = offset;
+        offset += g.end;
+        g.end = g.begin;
+    }
+
+    // second pass fills the buckets. walking argv in order keeps each bucket sorted
+    _shorts.resize(_short_offsets[NUM_SHORTS]);
+    _longs.resize(_group_of.size());
+    std::size_t fill[NUM_SHORTS];
+    std::copy(_short_offsets, _short_offsets + NUM_SHORTS, fill);
+    std::size_t nth_long = 0;
+    for (std::size_t i = 0; i < argc; i++) {
+        if (args.is_long(i) and args.name_len(i)) {
+            _longs[_groups[_group_of[nth_long++]].end++] = i;
+        }
+        for (auto bits = args.shorts(i); bits; bits &= bits - 1) {
+            _shorts[fill[__builtin_ctzll(bits)]++] = i;
+        }
+    }
+}
+
+void ArgIndex::find(
+    const char** argv, const ArgTable& args,
+    char s, const char* l,
+    ArenaVector<std::size_t>& out
+) const {
+    if (is_valid_short(s)) {
+        auto slot = short_slot(s);
+        out.insert(
+            out.end(),
+            _shorts.begin() + _short_offsets[slot],
+            _shorts.begin() + _short_offsets[slot + 1]
+        );
+    }
+
+    if ((l == nullptr) or _groups.empty()) {
+        return;
+    }
+
+    // an arg matches when its name is a prefix of `l`, so look up every prefix of `l`
+    std::size_t sources = out.empty() ? 0 : 1;
+    auto h = NAME_HASH_BASIS;
+    for (std::size_t n = 1; l[n-1] != '\0'; n++) {
+        h = name_hash_step(h, l[n-1]);
+
+        auto group = find_group(argv, args, l, n, name_hash_finish(h));
+        if (group != nullptr) {
+            out.insert(out.end(), _longs.begin() + group->begin, _longs.begin() + group->end);
+            sources++;
+        }
+    }
+
+    // shorts and each long name are already ordered, but not relative to one another
+    if (sources > 1) {
+        std::sort(out.begin(), out.end());
+    }
+}
+
+
+
+//
+// response files
+//
+
+static bool is_response_file(const char* arg) {
+    return (arg[0] == '@') and (arg[1] != '\0');
+}
+
+// splits [r, end) into tokens in place, calling `each` with every token.
+// unquoting only ever shrinks a token, so each is written over its own
+// text and terminated at the whitespace after it (or at `end`). stops at
+// the first error, whether its own or returned by `each`
+template <typename Fn>
+static Error tokenize(const char* path, char* r, char* end, Fn each) {
+    while (true) {
+        while ((r < end) and isspace(static_cast<unsigned char>(*r))) { r++; }
+        if (r == end) { return Error(); }
+
+        char* token = r;
+        char* w = r;
+        char quote = 0;
+        while (r < end) {
+            char c = *r;
+            if (quote) {
+                if (c == quote) { quote = 0; r++; continue; }
+            } else if (isspace(static_cast<unsigned char>(c))) {
+                break;
+            } else if ((c == '\'') or (c == '"')) {
+                quote = c;
+                r++;
+                continue;
+            }
+            if ((c == '\\') and (quote != '\'') and (r + 1 < end)) {
+                c = *(++r);
+            }
+            *w++ = c;
+            r++;
+        }
+        if (quote) {
+            return Error(ErrorCode::ResponseFileQuote, Error::npos, 0, nullptr, path);
+        }
+
+        *w = '\0';
+        if (r < end) { r++; }
+        auto err = each(token);
+        if (err) { return err; }
+    }
+}
+
+ResponseFiles::ResponseFiles(ResponseFiles&& o) noexcept
+    : _maps(std::move(o._maps))
+    , _argv(std::move(o._argv))
+{
+    o._maps.clear();
+}
+
+ResponseFiles& ResponseFiles::operator=(ResponseFiles&& o) noexcept {
+    if (this != &o) {
+        unmap();
+        _maps = std::move(o._maps);
+        _argv = std::move(o._argv);
+        o._maps.clear();
+    }
+    return *this;
+}
+
+void ResponseFiles::unmap() {
+    for (auto& m : _maps) {
+        munmap(m.addr, m.length);
+    }
+    _maps.clear();
+}
+
+void ResponseFiles::clear() {
+    unmap();
+    _argv.clear();
+}
+
+bool ResponseFiles::any(std::size_t argc, const char** argv) {
+    for (std::size_t i = 0; i < argc; i++) {
+        if (is_response_file(argv[i])) { return true; }
+    }
+    return false;
+}
+
+Error ResponseFiles::expand(std::size_t argc, const char** argv) {
+    unmap();
+    _argv.clear();
+
+    for (std::size_t i = 0; i < argc; i++) {
+        if (is_response_file(argv[i])) {
+            auto err = add(argv[i], 0);
+            if (err) {
+                err.index = i;
+                return err;
+            }
+        } else {
+            _argv.push_back(argv[i]);
+        }
+    }
+    return Error();
+}
+
+Error ResponseFiles::add(const char* arg, std::size_t depth) {
+    auto path = arg + 1;
+    if (depth >= MAX_DEPTH) {
+        return Error(ErrorCode::ResponseFileNested, Error::npos, 0, nullptr, path);
+    }
+
+    auto read_error = [&]() {
+        Error err(ErrorCode::ResponseFileUnreadable, Error::npos, 0, nullptr, path);
+        err.sys_errno = errno;
+        return err;
+    };
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { return read_error(); }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        auto err = read_error();
+        close(fd);
+        return err;
+    }
+    std::size_t size = st.st_size;
+    if (size == 0) {
+        close(fd);
+        return Error();
+    }
+
+    // reserve one byte past the file to terminate its last token: the tail
+    // of a partial last page reads as zeros, and a file ending exactly on a
+    // page boundary is followed by the anonymous page mapped beneath it
+    auto length = size + 1;
+    auto addr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+        auto err = read_error();
+        close(fd);
+        return err;
+    }
+    if (mmap(addr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        auto err = read_error();
+        munmap(addr, length);
+        close(fd);
+        return err;
+    }
+    close(fd);
+
+    _maps.push_back({addr, length});
+    madvise(addr, size, MADV_SEQUENTIAL);
+
+    auto begin = static_cast<char*>(addr);
+    return tokenize(path, begin, begin + size, [&](const char* token) {
+        if (is_response_file(token)) {
+            return add(token, depth + 1);
+        }
+        _argv.push_back(token);
+        return Error();
+    });
+}
+
+
+//
+// context
+//
+
+void Context::reset(std::size_t argc, const char** argv, char help_short, const char* help_long) {
+    _argset.reset(argc);
+    _argc = argc;
+    _argv = argv;
+    _help_short = help_short;
+    _help_long = help_long;
+    _level = 0;
+    _chain_ended = false;
+    _help = false;
+    _error = Error();
+    _diagnostics.clear();
+    _known_longs.clear();
+    forget_subcommands();
+
+    classify_args(argc, argv, help_short, help_long, _args);
+    for (std::size_t i = 0; i < argc; i++) {
+        if (_args.is_help(i)) {
+            _help = true;
+            _argset.set(i);
+        }
+    }
+
+    _index.build(_argc, _argv, _args);
+}
+
+void Context::release() {
+    _argset = BitSet(_arena);
+    _args = ArgTable(_arena);
+    _index = ArgIndex(_arena);
+    _matches = ArenaVector<std::size_t>(_arena);
+    _known_longs = ArenaVector<const char*>(_arena);
+    _known_subs = ArenaVector<const char*>(_arena);
+    _known_tables = ArenaVector<std::pair<const SubcommandDesc*, std::size_t>>(_arena);
+    _diagnostics = Diagnostics(_arena);
+    _responses.clear();
+    _argc = 0;
+    _argv = nullptr;
+}
+
+void Context::expand_response_files() {
+    // already expanded, or nothing to do
+    if ((_argv == _responses.argv()) or not ResponseFiles::any(_argc, _argv)) {
+        return;
+    }
+
+    auto err = _responses.expand(_argc, _argv);
+    if (err) {
+        fail(err);
+        return;
+    }
+    reset(_responses.argc(), _responses.argv(), _help_short, _help_long);
+}
+
+void Context::print_unused(std::ostream& s) const {
+    for (auto i = _argset.unset_begin(); i != _argset.unset_end(); ++i) {
+        s << " " << _argv[*i];
+        did_you_mean(s, _argv[*i], suggest(*i));
+    }
+}
+
+const char* Context::suggest(std::size_t i) const {
+    auto row = _args[i];
+    if (row.is_short()) {
+        return nullptr;
+    }
+
+    auto name = _argv[i];
+    if (row.is_long()) {
+        NearestName nearest(name + 2, row.name_len());
+        for (auto l : _known_longs) {
+            nearest.consider(l);
+        }
+        nearest.consider(_help_long);
+        return nearest.best();
+    }
+
+    if (_known_subs.empty() and _known_tables.empty()) {
+        return nullptr;
+    }
+    NearestName nearest(name, row.name_len());
+    for (auto sub : _known_subs) {
+        nearest.consider(sub);
+    }
+    for (auto& table : _known_tables) {
+        for (std::size_t t = 0; t < table.second; t++) {
+            nearest.consider(table.first[t].name);
+        }
+    }
+    return nearest.best();
+}
+
+void Context::take_flag(char s, const char* l, bool& into, bool invert) {
+    bool has_seen = false;
+    for (auto& arg : find(s, l)) {
+        // flags can only be set once so if we've seen it already, bail
+        if (has_seen or (arg.desc.matches(arg.c_str, s) > 1)) {
+            if (not fail(Error(ErrorCode::DuplicateFlag, arg.index, s, l))) {
+                return;
+            }
+            // collecting, so take every repeat of it in the run
+            has_seen = true;
+            into = not invert;
+            consume_run(arg.index, arg.desc.is_long() ? 1 : arg.desc.matches(arg.c_str, s));
+            continue;
+        }
+
+        has_seen = true;
+        into = not invert;
+        consume_run(arg.index, 1);
+    }
+}
+
+std::size_t Context::take_count(char s, const char* l) {
+    std::size_t count = 0;
+    for (auto& arg : find(s, l)) {
+        auto run_count = arg.desc.is_long() ? 1 : arg.desc.matches(arg.c_str, s);
+        count += run_count;
+        consume_run(arg.index, run_count);
+    }
+    return count;
+}
+
+void Context::consume_run(std::size_t i, std::size_t n) {
+    // a run may be shared with other flags, so only mark it
+    // as used once every character has been taken
+    if (_args.take_runs(i, n) == 0) {
+        used(i);
+    }
+}
+
+StringView Context::take_positional(std::size_t& at) {
+    // looks for the first positional argument and handles it
+    // this used to only operate on the first argument, but there are situations
+    // where this may not match valid usage patterns
+    for (auto& arg : *this) {
+        if (arg.desc.is_positional()) {
+            used(arg.index);
+            at = arg.index;
+            return StringView(arg.c_str, arg.desc.len());
+        }
+    }
+    return StringView();
+}
+
+void Context::validate() {
+    if (collecting()) {
+        for (auto& a : *this) {
+            fail(Error(ErrorCode::Unused, a.index, 0, suggest(a.index), a.c_str));
+        }
+        return;
+    }
+
+    if (remaining()) {
+        auto first = *begin();
+        Error err(ErrorCode::Unused, first.index, 0, suggest(first.index), first.c_str);
+        err.context = this;
+        fail(err);
+    }
+}
+
+
+//
+// parser
+//
+
+
+Parser& Parser::done() {
+    // handle groups first -- does not add a level though so skip that
+    if (_in_group) {
+        _in_group = false;
+        return *this;
+    }
+
+    if (_level > 0) {
+        _level--;
+    }
+
+    if (_level == (_ctx.level() - 1)) {
+        _ctx.end_chain();
+    }
+
+    return *this;
+}
+
+Parser& Parser::reset(std::size_t argc, const char** argv) {
+    // everything in the arena goes before it is rewound
+    _help.reset();
+    _ctx.release();
+    if (_arena) {
+        _arena->rewind();
+    }
+
+    _ctx.reset(argc-1, argv+1, _ctx.help_short(), _ctx.help_long());
+    _in_group = false;
+    _level = 0;
+    _embedded = nullptr;
+    _completing = false;
+    if (_complete.parse(argc, argv)) {
+        begin_completion();
+    }
+    if (_ctx.wants_help()) {
+        _help = arena_new<HelpMap>(_arena, _arena);
+        find_embedded();
+    }
+    return *this;
+}
+
+Parser& Parser::expand_response_files() {
+    // the words to complete are as the shell has them
+    if (_completing) {
+        return *this;
+    }
+
+    _ctx.expand_response_files();
+    if (_ctx.wants_help() and not _help) {
+        _help = arena_new<HelpMap>(_arena, _arena);
+        find_embedded();
+    }
+    return *this;
+}
+
+// whether tools/embed_help is running this program. read once, since
+// the environment does not change under a parser
+static bool generating_help() {
+    static const bool generating = [] {
+        auto value = getenv(EMBED_HELP_ENV);
+        return value and (strcmp(value, EMBED_HELP_VALUE) == 0);
+    }();
+    return generating;
+}
+
+void Parser::find_embedded() {
+    // generating the embedded help needs it built from the chain
+    if (_dynamic_help or generating_help()) {
+        _embedded = nullptr;
+        return;
+    }
+    _embedded = find_embedded_help(_help->subcommand_path());
+}
+
+bool Parser::subcommand_arg(const char* name, Context::iterator& arg) {
+    // subcommands only operate on the first available arg
+    // so we can just use the iterator. when collecting, args that
+    // cannot be subcommands are reported and skipped
+    while ((arg != _ctx.end()) and not arg.desc().is_positional()) {
+        if (_completing) {
+            // step over options given before the subcommand, and their values
+            bool has_value = _help->takes_value(arg.c_str(), arg.desc().len());
+            ++arg;
+            if (has_value and (arg != _ctx.end())) { ++arg; }
+            continue;
+        }
+        if (not _ctx.fail(Error(ErrorCode::NotAvailable, arg.index(), 0, name, arg.c_str()))) {
+            return false;
+        }
+        _ctx.used(arg.index());
+        ++arg;
+    }
+    return true;
+}
+
+void Parser::enter_subcommand(const Context::iterator& arg, const char* name, const char* desc) {
+    _ctx.used(arg.index());
+    _ctx.next_level();
+    // subcommands passed over are not suggested at the deeper level
+    _ctx.forget_subcommands();
+    // context indices skip the program name
+    _complete_from = arg.index() + 2;
+
+    if (wants_help()) {
+        // set this subcommand to be used in the details and usage lines
+        _help->subcommand_details(name, desc);
+        // delete any subcommands we have registered so far
+        _help->clear_subcommands();
+        // help for the deeper path may be embedded too
+        find_embedded();
+    }
+}
+
+void Parser::begin_completion() {
+    _completing = true;
+    _complete_from = 1;
+
+    // parse the words before the one completed (past the program name)
+    auto n = std::min(_complete.index, _complete.count);
+    _ctx.reset(n ? n - 1 : 0, _complete.words + 1, _ctx.help_short(), _ctx.help_long());
+    _ctx.help_only();
+}
+
+void Parser::print_completions() const {
+    std::string out;
+    if (_complete.shell) {
+        out = completion_script(_complete.shell, _complete.words[0]);
+    } else if (_dynamic_help or generating_help() or not complete(_complete, out)) {
+        // from what the chain registered along the subcommands it entered
+        std::string spec;
+        _help->completions(spec, _ctx.help_short(), _ctx.help_long());
+        complete_words(_complete, _complete_from, "", [&](const std::string& path) {
+            return path.empty() ? StringView(spec.data(), spec.size()) : StringView();
+        }, out);
+    }
+    write_all(STDOUT_FILENO, out.data(), out.size());
+}
+
+bool Parser::wants_help() const {
+    return _ctx.wants_help();
+}
+
+void Parser::print() const {
+    if (not _ctx.wants_help()) {
+        return;
+    }
+
+    // anything already buffered for stdout goes first
+    std::cout.flush();
+
+    if (_completing) {
+        print_completions();
+        return;
+    }
+
+    if (_embedded) {
+        write_all(STDOUT_FILENO, _embedded->text, _embedded->size);
+        return;
+    }
+
+    if (generating_help()) {
+        // for tools/embed_help: the subcommands here, one per line after
+        // their count, then the size of the help and the help itself, and
+        // the same for the completion spec
+        std::string text;
+        _help->render(text);
+        std::string spec;
+        _help->completions(spec, _ctx.help_short(), _ctx.help_long());
+
+        std::ostringstream record;
+        record << _help->_subs.size() << "\n";
+        for (auto& sub : _help->_subs) {
+            record.write(_help->text(sub.name), sub.name.len) << "\n";
+        }
+        record << text.size() << "\n" << text;
+        record << spec.size() << "\n" << spec;
+        auto out = record.str();
+        write_all(STDOUT_FILENO, out.data(), out.size());
+        return;
+    }
+
+    _help->write(STDOUT_FILENO);
+}
+
+ParseStatus Parser::status() const {
+    if (_ctx.failed()) {
+        return ParseStatus::Error;
+    }
+    return _ctx.wants_help() ? ParseStatus::Help : ParseStatus::Ok;
+}
+
+// finalizer that asserts no unused arguments
+void Parser::validate() {
+    // if we are just printing help (or already stopped), don't validate
+    if (_ctx.wants_help() or _ctx.stopped()) {
+        return;
+    }
+
+    _ctx.validate();
 }
 
 // finalizer that returns all unused args
@@ -5,18 +5,137 @@
 #include <iostream>
 #include <string>
 #include <cstring>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <type_traits>
+#include <utility>
 #include <vector>
-
-#ifdef __EXCEPTIONS
 #include <sstream>
+
+// whether errors may be thrown. defaults to the standard feature-test
+// macro (MSVC only defines _CPPUNWIND); define it to 0 or 1 to override
+#ifndef CLIKIT_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#define CLIKIT_EXCEPTIONS 1
+#else
+#define CLIKIT_EXCEPTIONS 0
+#endif
+#endif
+
+#if CLIKIT_EXCEPTIONS
 #include <exception>
 #endif
 
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
 namespace cli {
 
 
+//-------------------------------------------------------------------------
+// arena
+//-------------------------------------------------------------------------
+
+// Monotonic bump allocator backing the parser's internal containers.
+// Nothing is freed individually. rewind() releases everything at once
+// while keeping the memory, so a parser that is reset and reused stops
+// touching the heap once the arena has grown to fit its largest parse.
+class Arena {
+protected:
+    struct Block {
+        Block* next;
+        std::size_t size; // usable bytes after the header
+    };
+
+    Block* _head = nullptr; // current block, older ones follow
+    std::size_t _offset = 0;
+    std::size_t _block_size;
+
+    void grow(std::size_t min_size);
+    void release();
+
+public:
+    static const std::size_t DEFAULT_BLOCK_SIZE = 4096;
+
+    explicit Arena(std::size_t block_size = DEFAULT_BLOCK_SIZE) : _block_size(block_size) {}
+    Arena(const Arena&) = delete; // no copy
+    Arena& operator=(const Arena&) = delete; // no copy
+    ~Arena() { release(); }
+
+    void* allocate(std::size_t n, std::size_t align);
+
+    // frees every allocation at once. when the last round spilled over
+    // several blocks they are merged into one that fits it all
+    void rewind();
+
+    // bytes reserved from the heap
+    std::size_t capacity() const;
+};
+
+// Standard allocator over an Arena. Without an arena it is plain new and
+// delete, so arena-aware containers work the same standalone.
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    Arena* arena = nullptr;
+
+    ArenaAllocator() = default;
+    ArenaAllocator(Arena* a) : arena(a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& o) : arena(o.arena) {}
+
+    T* allocate(std::size_t n) {
+        if (arena == nullptr) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, std::size_t) {
+        if (arena == nullptr) {
+            ::operator delete(p);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& o) const { return arena == o.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& o) const { return arena != o.arena; }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+// unique_ptr deleter for objects made with arena_new()
+template <typename T>
+struct ArenaDelete {
+    Arena* arena = nullptr;
+
+    void operator()(T* p) const {
+        p->~T();
+        if (arena == nullptr) {
+            ::operator delete(p);
+        }
+    }
+};
+template <typename T>
+using ArenaPtr = std::unique_ptr<T, ArenaDelete<T>>;
+
+template <typename T, typename... Args>
+ArenaPtr<T> arena_new(Arena* arena, Args&&... args) {
+    void* mem = arena ? arena->allocate(sizeof(T), alignof(T)) : ::operator new(sizeof(T));
+    return ArenaPtr<T>(new (mem) T(std::forward<Args>(args)...), ArenaDelete<T>{arena});
+}
+
+
 //-------------------------------------------------------------------------
 // bitset
 //-------------------------------------------------------------------------
@@ -24,32 +143,63 @@ namespace cli {
 class BitSet {
 public:
     static const std::size_t BITS_PER_SIZET = sizeof(std::size_t) * 8;
+    static const std::size_t npos = std::size_t(-1);
+
+    // sets up to this many words (128 bits on 64 bit targets) are stored
+    // inline, larger ones spill to `data`
+    static const std::size_t INLINE_WORDS = 2;
 
 protected:
     // TODO: if only this could be a tempalte variable, but argc obviously runtime
     std::size_t N = 0;
-    std::vector<std::size_t> data;
+    std::size_t count = 0; // bits set, kept up to date by set/unset
+    std::size_t small[INLINE_WORDS] = {};
+    ArenaVector<std::size_t> data;
+    std::size_t* bits = small; // small or data
+
+    // second level: bit w is set when bits[w] is full, so walking the
+    // unset bits of a mostly set bitset skips 64 words at a time
+    std::size_t small_summary = 0;
+    ArenaVector<std::size_t> summary_data;
+    std::size_t* summary = &small_summary; // small_summary or summary_data
 
 protected:
     std::size_t num_elements() const;
     std::size_t arr_index(std::size_t linear) const;
     std::size_t bit_index(std::size_t linear) const;
 
+    // the value of bits[word] once every bit in it is set
+    std::size_t full_word(std::size_t word) const;
+    // first word at or after `word` with an unset bit, or num_elements()
+    std::size_t next_open_word(std::size_t word) const;
+
+    // points at the storage just taken from `o`, leaving it empty
+    void adopt(BitSet& o);
+
 public:
     BitSet() = default;
     BitSet(const BitSet&) = delete; // no copy
     BitSet& operator=(const BitSet&) = delete; // no copy
-    BitSet(BitSet&&) = default; // default move
-    BitSet& operator=(BitSet&&) = default; // default move
-    BitSet(std::size_t n)
-        : N(n)
-        , data(num_elements())
-    {}
+    BitSet(BitSet&& o) noexcept;
+    BitSet& operator=(BitSet&& o) noexcept;
+    BitSet(std::size_t n, Arena* arena = nullptr)
+        : data(arena)
+        , summary_data(arena)
+    {
+        reset(n);
+    }
+    explicit BitSet(Arena* arena) : data(arena), summary_data(arena) {}
+
+    // resizes to `n` bits, all unset, keeping allocated storage
+    void reset(std::size_t n);
 
+    // bits past the end throw std::runtime_error, or without exceptions
+    // are never set: set() returns npos and is_set() false
     std::size_t set(std::size_t linear);
     bool is_set(std::size_t linear);
     void unset(std::size_t linear);
 
+    // all O(1)
     std::size_t total() const;
     std::size_t remaining() const;
     std::size_t size() const;
@@ -79,7 +229,7 @@ public:
             if (set->total() == 0) {
                 return;
             }
-            if (not (set->data[0] & 0x01)) { find_next_bit(); }
+            if (not (set->bits[0] & 0x01)) { find_next_bit(); }
         }
         set_iterator(const BitSet* set, std::size_t index)
             : set(set)
@@ -138,7 +288,7 @@ public:
                 return;
             }
             // if LSB is set, find next zero, otherwise, we're at it
-            if (set->data[0] & 0x01) {find_next_zero(); }
+            if (set->bits[0] & 0x01) {find_next_zero(); }
         }
         unset_iterator(const BitSet* set, std::size_t index)
             : set(set)
@@ -192,16 +342,161 @@ public:
 // generic helper functions
 //-------------------------------------------------------------------------
 
-bool is_valid_short(char c);
+constexpr bool is_valid_short(char c) {
+    return ((c >= '0' and c <= '9'))
+        or ((c >= 'a') and (c <= 'z'))
+        or ((c >= 'A') and (c <= 'Z'));
+}
+
+// dense slot [0, NUM_SHORTS) for a valid short flag character
+static const std::size_t NUM_SHORTS = 62;
+constexpr std::size_t short_slot(char c) {
+    return ((c >= '0') and (c <= '9')) ? (c - '0')
+        : ((c >= 'a') and (c <= 'z')) ? (10 + (c - 'a'))
+        : (36 + (c - 'A'));
+}
 
 void arg_string(std::ostream& ss, char s, const char* l, bool pad = true);
 std::string arg_string(char s, const char* l, bool pad = true);
 
+// runs fn(begin, end) over contiguous slices of [0, n) on up to `threads`
+// threads (0 for one per core), giving each at least `min_per_thread`
+// items. the calling thread takes the first slice. fn must not throw
+void parallel_for(
+    std::size_t n, std::size_t threads, std::size_t min_per_thread,
+    void (*fn)(void* ctx, std::size_t begin, std::size_t end), void* ctx
+);
+template <typename Fn>
+void parallel_for(std::size_t n, std::size_t threads, std::size_t min_per_thread, Fn&& fn) {
+    // type erased by hand, as a std::function may allocate for the closure
+    using F = typename std::remove_reference<Fn>::type;
+    parallel_for(n, threads, min_per_thread, [](void* ctx, std::size_t begin, std::size_t end) {
+        (*static_cast<F*>(ctx))(begin, end);
+    }, const_cast<void*>(static_cast<const void*>(&fn)));
+}
+
 
 //-------------------------------------------------------------------------
 // errors
 //-------------------------------------------------------------------------
 
+class Context;
+struct SubcommandDesc;
+
+enum class ErrorCode : std::uint8_t {
+    None = 0,
+
+    // user input
+    Duplicate,          // an arg given more than once
+    DuplicateFlag,      // a flag given more than once
+    Run,                // a short taking a value given in a run
+    MissingValue,       // an arg without its value
+    MissingListValue,   // a list arg without its value
+    UnexpectedValue,    // a value given to a flag
+    UnknownArgument,    // a non-positional where only positionals remain
+    Unused,             // args left after validate()
+    NotAvailable,       // a non-positional where a subcommand was expected
+    MissingArgument,    // a required arg or positional not given
+    InvalidInteger,
+    IntegerOutOfRange,
+    InvalidNumber,
+    NumberOutOfRange,
+    ResponseFileUnreadable,
+    ResponseFileNested,
+    ResponseFileQuote,
+
+    // CLI building
+    NestedGroup,
+    ResponseFilesNeedScratch    // Spec::parse() without a Scratch to own the files
+};
+
+enum class ParseStatus : std::uint8_t {
+    Ok = 0,
+    Help,
+    Error   // only when errors are not thrown
+};
+
+// How a parser reports errors. Throw raises the first error as an
+// exception. Stop records it and turns the rest of the chain into no-ops,
+// leaving the error for the caller to inspect. Collect records every error
+// into Diagnostics and carries on, skipping past each offending arg.
+// Without exceptions (-fno-exceptions) Throw behaves as Stop.
+enum class OnError : std::uint8_t {
+    Throw = 0,
+    Stop,
+    Collect
+};
+
+#if CLIKIT_EXCEPTIONS
+static const OnError DEFAULT_ON_ERROR = OnError::Throw;
+#else
+static const OnError DEFAULT_ON_ERROR = OnError::Stop;
+#endif
+
+// A failed parse. Only what is needed to describe it is recorded, and the
+// message is formatted on request. It points into argv (and the parser for
+// Unused), so it is valid until the parser is reset or destroyed.
+class Error {
+public:
+    static const std::size_t npos = std::size_t(-1);
+
+    ErrorCode code = ErrorCode::None;
+    std::size_t index = npos;        // offending arg in argv, npos if none
+    char short_flag = 0;             // the registration it concerns
+    const char* long_flag = nullptr; // (the name for positionals, or the
+                                     // known name nearest an unknown arg)
+    const char* value = nullptr;     // offending text (arg, value or path)
+    int sys_errno = 0;               // for unreadable response files
+    const Context* context = nullptr; // lists the Unused args
+
+    Error() = default;
+    Error(ErrorCode c, std::size_t i, char s, const char* l, const char* v = nullptr)
+        : code(c), index(i), short_flag(s), long_flag(l), value(v)
+    {}
+
+    explicit operator bool() const { return code != ErrorCode::None; }
+
+    void message(std::ostream& s) const;
+    std::string message() const;
+
+    // throws the matching exception below, or without exceptions prints
+    // the message and aborts
+    [[noreturn]] void raise() const;
+};
+
+// Every error of a parse with OnError::Collect, in the order found. Each
+// is kept as a 24 byte entry and only becomes an Error (and a message)
+// when asked for. Leftover args are reported one entry each.
+class Diagnostics {
+protected:
+    struct Entry {
+        std::uint32_t index;
+        ErrorCode code;
+        char short_flag;
+        std::int16_t sys_errno;
+        const char* long_flag;
+        const char* value;
+    };
+
+    static const std::uint32_t NO_INDEX = std::uint32_t(-1);
+
+    ArenaVector<Entry> _entries;
+
+public:
+    explicit Diagnostics(Arena* arena = nullptr) : _entries(arena) {}
+
+    void add(const Error& e);
+    void clear() { _entries.clear(); }
+
+    std::size_t size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+    Error operator[](std::size_t i) const;
+
+    // writes each message on its own line
+    void print(std::ostream& s) const;
+};
+
+#if CLIKIT_EXCEPTIONS
 // Error type thrown when user input is bad.
 class ParseError : public std::exception {
 protected:
@@ -243,6 +538,104 @@ public:
 
     const char* what() const throw () { return err.c_str(); }
 };
+#endif
+
+
+//-------------------------------------------------------------------------
+// suggestions
+//-------------------------------------------------------------------------
+
+// Finds the candidate nearest to a mistyped name, for "did you mean"
+// hints. Distance is Damerau's (optimal string alignment: an adjacent
+// transposition is one edit), computed a candidate character at a time
+// over the whole name at once with bit vectors (Myers, Hyyro), and given
+// up on as soon as it must exceed the bound. The bound grows with the
+// name, from 1 edit to 3. Names over 64 characters are never matched.
+class NearestName {
+public:
+    static const std::size_t MAX_LEN = 64;
+
+protected:
+    // bit i of _eq[c] is set where name[i] == c
+    std::uint64_t _eq[256];
+    std::size_t _len;
+    std::size_t _bound;
+    const char* _best = nullptr;
+    std::size_t _best_distance;
+
+    std::size_t distance(const char* candidate, std::size_t len, std::size_t limit) const;
+
+public:
+    NearestName(const char* name, std::size_t len);
+    NearestName(const NearestName&) = delete;
+    NearestName& operator=(const NearestName&) = delete;
+
+    // the distance to `candidate`, or more than the bound if that far
+    std::size_t distance(const char* candidate, std::size_t len) const {
+        return distance(candidate, len, _bound);
+    }
+
+    // keeps `candidate` if within the bound and nearer than any before
+    void consider(const char* candidate);
+
+    // the nearest candidate considered, or nullptr if none were near
+    const char* best() const { return _best; }
+    std::size_t bound() const { return _bound; }
+};
+
+
+//-------------------------------------------------------------------------
+// string views
+//-------------------------------------------------------------------------
+
+// A non-owning view of a string, standing in for C++17's std::string_view.
+// Bound as a value it points straight into argv (past the '=' of
+// "--name=value"), so it is only valid as long as argv is. Views of argv
+// are always NUL terminated.
+class StringView {
+protected:
+    const char* _data = nullptr;
+    std::size_t _size = 0;
+
+public:
+    using value_type = char;
+    using const_iterator = const char*;
+
+    constexpr StringView() = default;
+    // explicit so plain C strings keep to the const char* conversions
+    explicit StringView(const char* s) : _data(s), _size(s ? strlen(s) : 0) {}
+    constexpr StringView(const char* s, std::size_t n) : _data(s), _size(n) {}
+
+    constexpr const char* data() const { return _data; }
+    constexpr std::size_t size() const { return _size; }
+    constexpr std::size_t length() const { return _size; }
+    constexpr bool empty() const { return _size == 0; }
+    constexpr const char* begin() const { return _data; }
+    constexpr const char* end() const { return _data + _size; }
+    constexpr char operator[](std::size_t i) const { return _data[i]; }
+
+    std::string str() const { return std::string(_data, _size); }
+
+    bool operator==(StringView o) const {
+        return (_size == o._size) and ((_size == 0) or (memcmp(_data, o._data, _size) == 0));
+    }
+    bool operator!=(StringView o) const { return not (*this == o); }
+};
+
+inline std::ostream& operator<<(std::ostream& s, StringView v) {
+    return s.write(v.data(), v.size());
+}
+
+// Types bound as views of the arg rather than converted from it. Built
+// from (data, size), so specialize it for other string_view-like types.
+template <typename T>
+struct is_view : std::false_type {};
+template <>
+struct is_view<StringView> : std::true_type {};
+#if __cplusplus >= 201703L
+template <>
+struct is_view<std::string_view> : std::true_type {};
+#endif
 
 
 //-------------------------------------------------------------------------
@@ -255,6 +648,61 @@ Into From(const char* s) {
     return Into(s);
 }
 
+enum class ConvertError : std::uint8_t {
+    None = 0,
+    Empty,    // nothing to convert
+    Invalid,  // not a number, or trailing characters
+    Overflow  // does not fit in the target type
+};
+
+// Locale independent integer parsing that never allocates or throws.
+//
+//     [+|-] (digits | 0x hex | 0o octal | 0b binary) [suffix]
+//
+// Leading zeros are decimal ("010" is ten). The optional suffix scales
+// by powers of 1024 for K, M, G, T, P, E (also "Ki"/"KiB" and so on; 'k'
+// may be lower case) or powers of 1000 when followed by 'B' ("KB", "MB").
+// Hex digits are read before suffixes, so "0x1E" is thirty.
+ConvertError parse_integer(
+    const char* s,
+    std::uint64_t max_positive, std::uint64_t max_negative,
+    std::uint64_t& magnitude, bool& negative
+);
+
+template <typename T>
+ConvertError parse_integer(const char* s, T& out) {
+    static_assert(std::is_integral<T>::value, "parse_integer requires an integral type");
+    using U = typename std::make_unsigned<T>::type;
+
+    std::uint64_t max_positive = std::numeric_limits<T>::max();
+    std::uint64_t max_negative = std::is_signed<T>::value ? max_positive + 1 : 0;
+
+    std::uint64_t magnitude = 0;
+    bool negative = false;
+    auto err = parse_integer(s, max_positive, max_negative, magnitude, negative);
+    if (err == ConvertError::None) {
+        out = static_cast<T>(negative ? U(0) - static_cast<U>(magnitude) : static_cast<U>(magnitude));
+    }
+    return err;
+}
+
+// Locale independent, correctly rounded decimal to binary floating point
+// conversion that never allocates or throws.
+//
+//     [+|-] (digits [. digits] | . digits) [(e|E) [+|-] digits]
+//     [+|-] (inf | infinity | nan)
+//
+// Hex floats ("0x1.8p3") are handed to strtod in the C locale, as is
+// long double. Finite values too large for the type are an Overflow, and
+// values too small round to zero or a subnormal like strtod.
+//
+// With `end` null the whole string must be the number. Otherwise parsing
+// stops at the first character that is not part of it, and `end` points
+// there.
+ConvertError parse_float(const char* s, float& out, const char** end = nullptr);
+ConvertError parse_float(const char* s, double& out, const char** end = nullptr);
+ConvertError parse_float(const char* s, long double& out, const char** end = nullptr);
+
 // unsigned
 template<> std::uint8_t From<std::uint8_t>(const char* s);
 template<> std::uint16_t From<std::uint16_t>(const char* s);
@@ -274,268 +722,609 @@ template<> float From<float>(const char* s);
 template<> double From<double>(const char* s);
 template<> long double From<long double>(const char* s);
 
-// emplace -- containters
+// Conversion that reports failure rather than throwing, leaving `out`
+// untouched on error. Defaults to From<Into>, which can only fail by
+// throwing, so specialize it for types whose conversion can fail when
+// parsing without exceptions.
 template <typename Into>
-auto Emplace(Into& into, const char* arg)
--> typename std::enable_if<
-    std::is_constructible<typename Into::value_type, const char*>::value,
-void>::type
+ErrorCode TryFrom(const char* s, Into& out) {
+    out = From<Into>(s);
+    return ErrorCode::None;
+}
+
+// unsigned
+template<> ErrorCode TryFrom<std::uint8_t>(const char* s, std::uint8_t& out);
+template<> ErrorCode TryFrom<std::uint16_t>(const char* s, std::uint16_t& out);
+template<> ErrorCode TryFrom<std::uint32_t>(const char* s, std::uint32_t& out);
+template<> ErrorCode TryFrom<std::uint64_t>(const char* s, std::uint64_t& out);
+
+// signed
+template<> ErrorCode TryFrom<std::int8_t>(const char* s, std::int8_t& out);
+template<> ErrorCode TryFrom<std::int16_t>(const char* s, std::int16_t& out);
+template<> ErrorCode TryFrom<std::int32_t>(const char* s, std::int32_t& out);
+template<> ErrorCode TryFrom<std::int64_t>(const char* s, std::int64_t& out);
+
+// floats
+template<> ErrorCode TryFrom<float>(const char* s, float& out);
+template<> ErrorCode TryFrom<double>(const char* s, double& out);
+template<> ErrorCode TryFrom<long double>(const char* s, long double& out);
+
+// converts `arg` with TryFrom and hands the value to `use`. types without
+// a default constructor go through From instead
+template <typename T, typename Fn>
+auto Convert(const char* arg, Fn&& use)
+-> typename std::enable_if<std::is_default_constructible<T>::value, ErrorCode>::type
 {
-    into.emplace_back(arg);
+    T value;
+    auto err = TryFrom(arg, value);
+    if (err == ErrorCode::None) {
+        use(std::move(value));
+    }
+    return err;
 }
-template <typename Into>
-auto Emplace(Into& into, const char* arg)
+template <typename T, typename Fn>
+auto Convert(const char* arg, Fn&& use)
+-> typename std::enable_if<not std::is_default_constructible<T>::value, ErrorCode>::type
+{
+    use(From<T>(arg));
+    return ErrorCode::None;
+}
+
+// construct -- builds a value from an arg, with an allocator when it can
+// take one (uses-allocator construction). Values bound for an
+// allocator-aware container then live in the container's memory resource
+// rather than on the default heap.
+template <typename T, typename Alloc>
+struct allocator_construction : std::integral_constant<int,
+    (not std::uses_allocator<T, Alloc>::value or std::is_same<Alloc, std::allocator<T>>::value) ? 0
+    : std::is_constructible<T, std::allocator_arg_t, const Alloc&, const char*>::value ? 1
+    : std::is_constructible<T, const char*, const Alloc&>::value ? 2
+    : 0
+> {};
+
+template <typename T, typename Alloc>
+T Construct(const char* arg, const Alloc& alloc, std::integral_constant<int, 1>) {
+    return T(std::allocator_arg, alloc, arg);
+}
+template <typename T, typename Alloc>
+T Construct(const char* arg, const Alloc& alloc, std::integral_constant<int, 2>) {
+    return T(arg, alloc);
+}
+template <typename T, typename Alloc>
+auto Construct(const char* arg, const Alloc&, std::integral_constant<int, 0>)
+-> typename std::enable_if<std::is_constructible<T, const char*>::value, T>::type
+{
+    return T(arg);
+}
+template <typename T, typename Alloc>
+auto Construct(const char* arg, const Alloc&, std::integral_constant<int, 0>)
+-> typename std::enable_if<not std::is_constructible<T, const char*>::value, T>::type
+{
+    return From<T>(arg);
+}
+template <typename T, typename Alloc>
+T Construct(const char* arg, const Alloc& alloc) {
+    return Construct<T>(arg, alloc, allocator_construction<T, Alloc>{});
+}
+
+// as Construct, assigning `out` and reporting conversion failures
+template <typename T, typename Alloc>
+auto TryConstruct(const char* arg, const Alloc& alloc, T& out)
 -> typename std::enable_if<
-    not std::is_constructible<typename Into::value_type, const char*>::value
-    and std::is_move_constructible<typename Into::value_type>::value
-, void>::type
+    (allocator_construction<T, Alloc>::value != 0) or std::is_constructible<T, const char*>::value,
+ErrorCode>::type
 {
-    into.emplace_back(std::move(From<typename Into::value_type>(arg)));
+    out = Construct<T>(arg, alloc);
+    return ErrorCode::None;
 }
-template <typename Into>
-auto Emplace(Into& into, const char* arg)
+template <typename T, typename Alloc>
+auto TryConstruct(const char* arg, const Alloc&, T& out)
 -> typename std::enable_if<
-    not std::is_constructible<typename Into::value_type, const char*>::value
-    and not std::is_move_constructible<typename Into::value_type>::value
-, void>::type
+    (allocator_construction<T, Alloc>::value == 0) and not std::is_constructible<T, const char*>::value,
+ErrorCode>::type
 {
-    into.push_back(From<typename Into::value_type>(arg));
+    return TryFrom(arg, out);
 }
 
+// appends to sequences (emplace_back) and inserts into sets (emplace)
+template <typename Into, typename... Args>
+auto Insert(Into& into, int, Args&&... args)
+-> decltype(into.emplace_back(std::forward<Args>(args)...), void())
+{
+    into.emplace_back(std::forward<Args>(args)...);
+}
+template <typename Into, typename... Args>
+auto Insert(Into& into, long, Args&&... args)
+-> decltype(into.emplace(std::forward<Args>(args)...), void())
+{
+    into.emplace(std::forward<Args>(args)...);
+}
 
-//-------------------------------------------------------------------------
-// shared / fwdecls / enums
-//-------------------------------------------------------------------------
-
-enum class ArgReq : std::uint8_t {
-    Optional = 0,
-    Required
-};
-
-
-//-------------------------------------------------------------------------
-// help / printing descriptors
-//-------------------------------------------------------------------------
-
-struct Description {
-    const char* name = "";
-    std::size_t name_len = 0;
-
-    const char* short_desc = "";
-    std::size_t short_len = 0;
-
-    const char* long_desc = "";
-    std::size_t long_len = 0;
-
-    Description() = default; // TODO: maybe not
-    Description(
-        const char* n, std::size_t n_len,
-        const char* s, std::size_t s_len,
-        const char* l, std::size_t l_len
-    )
-        : name(n), name_len(n_len)
-        , short_desc(s), short_len(s_len)
-        , long_desc(l), long_len(s_len)
-    {}
-    Description(const char* n, const char* s, const char* l)
-        // TODO: strnlen -- set a MEX_LENGTH variable? #define?
-    {
-        if (n == nullptr) { n = ""; }
-        if (s == nullptr) { s = ""; }
-        if (l == nullptr) { l = ""; }
-
-        name = n;
-        name_len = strlen(n);
-
-        short_desc = s;
-        short_len = strlen(s);
+// inserts a converted value, copying those that cannot be moved
+template <typename Into, typename T>
+auto Append(Into& into, T& value)
+-> typename std::enable_if<std::is_move_constructible<T>::value>::type
+{
+    Insert(into, 0, std::move(value));
+}
+template <typename Into, typename T>
+auto Append(Into& into, T& value)
+-> typename std::enable_if<not std::is_move_constructible<T>::value>::type
+{
+    into.push_back(value);
+}
 
-        long_desc = l;
-        long_len = strlen(l);
+// makes room for `n` more values in containers that can reserve. growth
+// stays geometric, as appending to the same container over several
+// registrations (or parses) would otherwise reserve exactly each time
+template <typename Into>
+auto Reserve(Into& into, std::size_t n, int)
+-> decltype(into.reserve(n), into.capacity(), void())
+{
+    auto want = into.size() + n;
+    if (want > into.capacity()) {
+        into.reserve(std::max<std::size_t>(want, 2 * into.capacity()));
     }
-};
+}
+// hashed containers, by the values their buckets can hold
+template <typename Into>
+auto ReserveHashed(Into& into, std::size_t n, int)
+-> decltype(into.reserve(n), into.bucket_count(), void())
+{
+    auto want = into.size() + n;
+    if (want > into.bucket_count() * into.max_load_factor()) {
+        into.reserve(std::max<std::size_t>(want, 2 * into.size()));
+    }
+}
+template <typename Into>
+void ReserveHashed(Into&, std::size_t, long) {}
+template <typename Into>
+void Reserve(Into& into, std::size_t n, long) {
+    ReserveHashed(into, n, 0);
+}
+template <typename Into>
+void Reserve(Into& into, std::size_t n) {
+    Reserve(into, n, 0);
+}
 
-struct ArgHelp {
-    char short_flag;
-    const char* long_flag;
+// emplace -- containers
+template <typename Into>
+ErrorCode Emplace(Into& into, const char* arg, std::true_type) {
+    Insert(into, 0, arg);
+    return ErrorCode::None;
+}
+template <typename Into>
+ErrorCode Emplace(Into& into, const char* arg, std::false_type) {
+    using T = typename Into::value_type;
+    return Convert<T>(arg, [&](T&& value) {
+        Append(into, value);
+    });
+}
+template <typename Into, typename T = typename Into::value_type>
+ErrorCode Emplace(Into& into, const char* arg, std::integral_constant<int, 0>) {
+    // built in place when the allocator does not matter
+    using Direct = std::integral_constant<bool, std::is_constructible<T, const char*>::value>;
+    return Emplace(into, arg, Direct{});
+}
+template <typename Into, int Kind>
+ErrorCode Emplace(Into& into, const char* arg, std::integral_constant<int, Kind> kind) {
+    using T = typename Into::value_type;
+    Insert(into, 0, Construct<T>(arg, into.get_allocator(), kind));
+    return ErrorCode::None;
+}
+template <typename Into>
+auto Emplace(Into& into, const char* arg, int)
+-> decltype(into.get_allocator(), ErrorCode())
+{
+    using Kind = allocator_construction<typename Into::value_type, typename Into::allocator_type>;
+    return Emplace(into, arg, Kind{});
+}
+// containers without an allocator construct values on their own
+template <typename Into>
+auto Emplace(Into& into, const char* arg, long)
+-> decltype(static_cast<typename Into::value_type*>(nullptr), ErrorCode())
+{
+    return Emplace(into, arg, std::integral_constant<int, 0>{});
+}
+template <typename Into>
+auto Emplace(Into& into, const char* arg)
+-> decltype(Emplace(into, arg, 0))
+{
+    return Emplace(into, arg, 0);
+}
 
-    const char* arg_name; // i.e.   -f/--file FILE
-    std::size_t name_len = 0;
-    const char* desc;
-    std::size_t desc_len = 0;
-    ArgReq _require;
+// sink -- hands each value to a consumer rather than storing it
+//
+// Lets list() and all_positionals() stream their values in argv order, so
+// huge lists never need to be held at once. The consumer is either a
+// callable taking a T or an output iterator of T (e.g. std::back_inserter),
+// and values are converted with From<T>:
+//
+//     parse.list("id", "ids to delete", cli::sink<std::uint64_t>([&](std::uint64_t id) {
+//         remove(id);
+//     }));
+template <typename T, typename Consumer>
+class Sink {
+protected:
+    Consumer _consumer;
 
-    ArgHelp(
-        char s, const char* l,
-        const char* name="",
-        const char* desc=""
-    )
-        : short_flag(s)
-        , long_flag(l)
-        , arg_name(name)
-        , desc(desc)
-    {
-        // TODO: stnlen -- but need a mex length variable of some sort
-        if (name != nullptr) { name_len = strlen(name); } else { name = ""; }
-        if (desc != nullptr) { desc_len = strlen(desc); } else { desc = ""; }
+    template <typename C>
+    static auto emit(C& c, T&& value, int)
+    -> decltype(c(std::move(value)), void()) {
+        c(std::move(value));
     }
-
-    std::size_t left_col_width() const {
-        // TODO: get count without creating the string
-        // 1 for the space between arg and name
-        return arg_string(short_flag, long_flag).size() + name_len + 1;
+    template <typename C>
+    static void emit(C& c, T&& value, long) {
+        *c = std::move(value);
+        ++c;
     }
 
-    std::string flags_string() const {
-        return arg_string(short_flag, long_flag);
+    ErrorCode take(StringView arg, std::true_type) {
+        emit(_consumer, T(arg.data(), arg.size()), 0);
+        return ErrorCode::None;
     }
-
-    bool required() const {
-        return _require == ArgReq::Required;
+    ErrorCode take(StringView arg, std::false_type) {
+        return (*this)(arg.data());
     }
-};
-
-struct PositionalHelp {
-    const char* name; // i.e.   -f/--file FILE
-    std::size_t name_len = 0;
-    const char* desc;
-    std::size_t desc_len = 0;
-    bool _is_variadic = false;
-    bool _required = false;
 
-    PositionalHelp(const char* name, const char* desc="")
-        : name(name)
-        , desc(desc)
-        , _is_variadic(false)
-        , _required(false)
-    {
-        // TODO: strnlen -- but need a max length variable of some sort
-        if (name != nullptr) { name_len = strlen(name); } else { name = ""; }
-        if (desc != nullptr) { desc_len = strlen(desc); } else { desc = ""; }
-    }
+public:
+    explicit Sink(Consumer c) : _consumer(std::move(c)) {}
 
-    PositionalHelp(bool variadic, ArgReq required, const char* name, const char* desc="")
-        : PositionalHelp(name, desc)
-    {
-        _is_variadic = variadic;
-        _required = required == ArgReq::Required;
+    ErrorCode operator()(const char* arg) {
+        return Convert<T>(arg, [&](T&& value) {
+            emit(_consumer, std::move(value), 0);
+        });
     }
-
-    std::size_t left_col_width() const {
-        return name_len + (variadic() ? 3 : 0);
+    // views are handed the arg as is
+    ErrorCode operator()(StringView arg) {
+        return take(arg, is_view<T>{});
     }
 
-    bool variadic() const { return _is_variadic; }
-    bool required() const { return _required; }
+    // the consumer, e.g. to recover an output iterator's position
+    Consumer& consumer() { return _consumer; }
 };
 
-class HelpMap {
-public:
-    using GroupValue = std::pair<Description, std::vector<ArgHelp>>;
-
-    std::vector<Description> _subs;
-    std::vector<GroupValue> _groups;
-    std::vector<ArgHelp> _args;
-    std::vector<PositionalHelp> _pos;
-
-    Description _desc;
-    const char* _app_version;
+template <typename T, typename Consumer>
+Sink<T, Consumer> sink(Consumer c) {
+    return Sink<T, Consumer>(std::move(c));
+}
 
-    std::string _subcommands;
-    Description _subcommand_desc;
+template <typename T, typename Consumer>
+ErrorCode Emplace(Sink<T, Consumer>& into, const char* arg) {
+    return into(arg);
+}
+template <typename T, typename Consumer>
+ErrorCode Emplace(Sink<T, Consumer>& into, StringView arg) {
+    return into(arg);
+}
 
-    std::size_t _longest_flag;
-    std::size_t _indent_width;
+// parallel -- converts a list's values on several threads
+//
+// list() first collects the matching args, then converts them into a
+// presized tail of the container on up to `threads` threads (0 for one
+// per core). Worth it for long lists with an expensive From<T>. The
+// container must be resizable and random access, like std::vector. If
+// an arg fails to convert, the container keeps only the values before it
+// and its error is reported (or rethrown), just as when converting in order.
+static const std::size_t PARALLEL_CONVERT_PER_THREAD = 1 << 12;
 
+template <typename Into>
+class Parallel {
 protected:
+    using T = typename Into::value_type;
 
-    static void indent_stream(std::ostream& s, std::size_t indent) {
-        for (std::size_t i = 0; i < indent; i++) {
-            s << " ";
-        }
-    }
+    Into& _into;
+    std::size_t _threads;
 
-    static std::string combine_all_shorts(const std::vector<const ArgHelp*> args) {
-        std::stringstream ss;
-        for (auto& a : args) {
-            if (is_valid_short(a->short_flag)) {
-                ss << a->short_flag;
+public:
+    Parallel(Into& into, std::size_t threads) : _into(into), _threads(threads) {}
+
+    // returns the position in `args` of the first value that failed to
+    // convert, setting `err`, or args.size() when all converted
+    std::size_t convert(const std::vector<const char*>& args, ErrorCode& err) {
+        auto base = _into.size();
+        _into.resize(base + args.size());
+
+        // each slice stops at its first failure, and the earliest one wins
+        std::size_t failed = args.size();
+        ErrorCode code = ErrorCode::None;
+#if CLIKIT_EXCEPTIONS
+        std::exception_ptr error;
+#endif
+        std::mutex lock;
+        auto fail = [&](std::size_t i, ErrorCode e) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (i < failed) {
+                failed = i;
+                code = e;
+#if CLIKIT_EXCEPTIONS
+                error = (e == ErrorCode::None) ? std::current_exception() : nullptr;
+#endif
             }
-        }
-        return ss.str();
-    }
-
-    static std::string combine_all_nonshorts(const std::vector<const ArgHelp*> args) {
-        std::stringstream ss;
-        for (auto& a : args) {
-            if (is_valid_short(a->short_flag)) {
-                continue;
+        };
+        parallel_for(args.size(), _threads, PARALLEL_CONVERT_PER_THREAD, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; i++) {
+                auto e = ErrorCode::None;
+#if CLIKIT_EXCEPTIONS
+                try {
+                    e = TryConstruct(args[i], _into.get_allocator(), _into[base + i]);
+                } catch (...) {
+                    return fail(i, ErrorCode::None);
+                }
+#else
+                e = TryConstruct(args[i], _into.get_allocator(), _into[base + i]);
+#endif
+                if (e != ErrorCode::None) {
+                    return fail(i, e);
+                }
             }
+        });
 
-            if (ss.tellp()) {
-                ss << " ";
+        if (failed < args.size()) {
+            _into.resize(base + failed);
+#if CLIKIT_EXCEPTIONS
+            if (error) {
+                std::rethrow_exception(error);
             }
-
-            ss << "--" << a->long_flag;
+#endif
         }
-        return ss.str();
+        err = code;
+        return failed;
+    }
+};
+
+template <typename Into>
+Parallel<Into> parallel(Into& into, std::size_t threads = 0) {
+    return Parallel<Into>(into, threads);
+}
+
+// assign -- single values, or appended when given a container
+template <typename T>
+auto AllocatorOf(const T& t, int) -> decltype(t.get_allocator()) {
+    return t.get_allocator();
+}
+template <typename T>
+std::allocator<T> AllocatorOf(const T&, long) {
+    return {};
+}
+
+template <typename Into>
+auto Assign(Into& into, const char* arg)
+-> typename std::enable_if<
+    std::is_constructible<typename Into::value_type, const char*>::value,
+ErrorCode>::type
+{
+    return Emplace(into, arg);
+}
+template <typename Into>
+auto Assign(Into& into, const char* arg)
+-> typename std::enable_if<std::is_constructible<Into, const char*>::value, ErrorCode>::type
+{
+    // keeps the allocator of allocator-aware values (i.e. strings)
+    into = Construct<Into>(arg, AllocatorOf(into, 0));
+    return ErrorCode::None;
+}
+
+// views -- Context hands every value over as a StringView of argv, its
+// length known from classification. View targets take it as is, so
+// nothing is measured or copied, and anything else converts from the
+// (terminated) C string as above.
+template <typename Into>
+auto TryFrom(StringView arg, Into& out)
+-> typename std::enable_if<is_view<Into>::value, ErrorCode>::type
+{
+    out = Into(arg.data(), arg.size());
+    return ErrorCode::None;
+}
+template <typename Into>
+auto TryFrom(StringView arg, Into& out)
+-> typename std::enable_if<not is_view<Into>::value, ErrorCode>::type
+{
+    return TryFrom(arg.data(), out);
+}
+
+template <typename Into>
+auto Emplace(Into& into, StringView arg)
+-> typename std::enable_if<is_view<typename Into::value_type>::value, ErrorCode>::type
+{
+    Insert(into, 0, arg.data(), arg.size());
+    return ErrorCode::None;
+}
+template <typename Into>
+auto Emplace(Into& into, StringView arg)
+-> typename std::enable_if<
+    not is_view<typename Into::value_type>::value,
+decltype(Emplace(into, arg.data()))>::type
+{
+    return Emplace(into, arg.data());
+}
+
+template <typename Into>
+auto Assign(Into& into, StringView arg)
+-> typename std::enable_if<
+    std::is_constructible<typename Into::value_type, const char*>::value,
+ErrorCode>::type
+{
+    return Emplace(into, arg);
+}
+template <typename Into>
+auto Assign(Into& into, StringView arg)
+-> typename std::enable_if<is_view<Into>::value, ErrorCode>::type
+{
+    into = Into(arg.data(), arg.size());
+    return ErrorCode::None;
+}
+template <typename Into>
+auto Assign(Into& into, StringView arg)
+-> typename std::enable_if<
+    not is_view<Into>::value and std::is_constructible<Into, const char*>::value,
+ErrorCode>::type
+{
+    return Assign(into, arg.data());
+}
+
+
+//-------------------------------------------------------------------------
+// shared / fwdecls / enums
+//-------------------------------------------------------------------------
+
+enum class ArgReq : std::uint8_t {
+    Optional = 0,
+    Required
+};
+
+
+//-------------------------------------------------------------------------
+// help / printing descriptors
+//-------------------------------------------------------------------------
+
+// a string held in a StringTable
+struct TextRef {
+    std::uint32_t offset = 0;
+    std::uint32_t len = 0;
+};
+
+// append only storage for help text. identical strings are stored once, so
+// names and descriptions repeated across options ("FILE", "N", ...) cost
+// nothing past their first use and every entry is a fixed size TextRef
+class StringTable {
+protected:
+    ArenaString _text;
+    ArenaVector<TextRef> _strings;
+    // open addressed set of the strings. a slot is a string's hash in the
+    // upper 32 bits and its index into _strings plus one below (0 is empty)
+    ArenaVector<std::uint64_t> _slots;
+
+    // the text appended to _text since `begin`, or an earlier equal string
+    TextRef commit(std::size_t begin);
+    void grow();
+
+public:
+    StringTable(Arena* arena = nullptr)
+        : _text(arena)
+        , _strings(arena)
+        , _slots(arena)
+    {}
+
+    TextRef intern(const char* s, std::size_t n);
+    TextRef intern(const char* s) {
+        return (s == nullptr) ? TextRef() : intern(s, strlen(s));
+    }
+    // the padded arg_string() of the flags, i.e. "-f/--file" or "   --file".
+    // appended as is, they are unique to an option
+    TextRef add_flags(char s, const char* l);
+
+    // not terminated, read `r.len` bytes
+    const char* data(TextRef r) const { return _text.data() + r.offset; }
+
+    // bytes of distinct text stored
+    std::size_t size() const { return _text.size(); }
+};
+
+struct Description {
+    TextRef name;
+    TextRef short_desc;
+    TextRef long_desc;
+};
+
+struct ArgHelp {
+    char short_flag = 0;
+    TextRef flags;    // i.e. "-f/--file"
+    TextRef arg_name; // i.e.   -f/--file FILE
+    TextRef desc;
+    ArgReq _require = ArgReq::Optional;
+    bool takes_value = false;
+
+    bool has_long() const { return flags.len > 2; }
+    // the long name, past the "-f/--" in flags
+    TextRef long_flag() const {
+        return has_long() ? TextRef{flags.offset + 5, flags.len - 5} : TextRef();
+    }
+
+    std::size_t left_col_width() const {
+        // 1 for the space between arg and name
+        return flags.len + arg_name.len + 1;
+    }
+
+    bool required() const {
+        return _require == ArgReq::Required;
+    }
+};
+
+struct PositionalHelp {
+    TextRef name;
+    TextRef desc;
+    bool _is_variadic = false;
+    bool _required = false;
+
+    std::size_t left_col_width() const {
+        return name.len + (variadic() ? 3 : 0);
     }
 
+    bool variadic() const { return _is_variadic; }
+    bool required() const { return _required; }
+};
+
+class HelpMap {
+public:
+    using GroupValue = std::pair<Description, ArenaVector<ArgHelp>>;
+
+    StringTable _strings;
+
+    ArenaVector<Description> _subs;
+    ArenaVector<GroupValue> _groups;
+    ArenaVector<ArgHelp> _args;
+    ArenaVector<PositionalHelp> _pos;
+
+    Description _desc;
+    const char* _app_version;
+
+    ArenaString _subcommands;
+    Description _subcommand_desc;
+
+    std::size_t _longest_flag;
+    std::size_t _indent_width;
+
+protected:
+
     // returns whether there are an args registered (including in groups)
     // but subcommands do not count as they are not args
     bool has_args() const;
 
-    // outputs the args portion of the usage line to the given stream
-    void print_usage_args(std::ostream& ss) const;
+    Description describe(const char* name, const char* desc, const char* long_desc);
+
+    // the help text is rendered twice through these, once to measure it
+    // and once into a buffer of exactly that size
+    template <typename Out>
+    void render_usage_args(Out& out) const;
+    template <typename Out>
+    void render(Out& out) const;
 
 public:
-    HelpMap()
-        : _app_version(nullptr)
-        , _longest_flag(0)
-        , _indent_width(4)
-    {}
-    HelpMap(const char* name, const char* short_desc)
-        : _desc(name, short_desc, "")
+    HelpMap(Arena* arena = nullptr)
+        : _strings(arena)
+        , _subs(arena)
+        , _groups(arena)
+        , _args(arena)
+        , _pos(arena)
         , _app_version(nullptr)
+        , _subcommands(arena)
         , _longest_flag(0)
         , _indent_width(4)
     {}
-
-    template <typename... Args>
-    void add_arg(bool in_group, const Args ...h) {
-        if (in_group) {
-            _groups.back().second.emplace_back(h...);
-
-            auto added = _groups.back().second.back();
-            _longest_flag = std::max(
-                _longest_flag,
-                _indent_width + added.left_col_width() // extra indent
-            );
-        } else {
-            _args.emplace_back(h...);
-            _longest_flag = std::max(
-                _longest_flag,
-                _args.back().left_col_width()
-            );
-        }
-    }
-
-    template <typename... Args>
-    void add_positional(const Args ...h) {
-        _pos.emplace_back(h...);
-        _longest_flag = std::max(
-            _longest_flag,
-            _pos.back().left_col_width()
-        );
+    HelpMap(const char* name, const char* short_desc, Arena* arena = nullptr)
+        : HelpMap(arena)
+    {
+        details(name, short_desc);
     }
 
-    template <typename... Args>
-    void add_variadic_positional(const Args ...h) {
-        _pos.emplace_back(true, h...);
-        _longest_flag = std::max(
-            _longest_flag,
-            _pos.back().left_col_width()
-        );
+    void add_arg(
+        bool in_group, char s, const char* l,
+        const char* name="", const char* desc="", bool takes_value=false
+    );
+    void add_positional(bool variadic, ArgReq required, const char* name, const char* desc="");
+    void add_variadic_positional(const char* name, const char* desc="") {
+        add_positional(true, ArgReq::Optional, name, desc);
     }
 
     void details(const char* name, const char* desc, const char* long_desc="");
@@ -543,9 +1332,100 @@ public:
     void clear_subcommands();
     void add_subcommand(const char* name, const char* desc);
     void new_group(const char* name, const char* desc);
+
+    // replaces `out` with the help text, formatted in place after sizing it
+    void render(std::string& out) const;
+    // writes the rendered help to the stream at once
     void print(std::ostream& s) const;
+    // writes the rendered help to `fd` with a single write(2), unless it
+    // comes up short. returns false if it fails
+    bool write(int fd) const;
+
+    // the matched subcommands, each preceded by a space ("" at the top)
+    const char* subcommand_path() const { return _subcommands.c_str(); }
+
+    const char* text(TextRef r) const { return _strings.data(r); }
+
+    // whether `arg` is exactly the short or long flag of an option taking a value
+    bool takes_value(const char* arg, std::size_t len) const;
+
+    // appends the completion spec of what is registered (see complete()): a
+    // line per subcommand, "c" then its name, and per flag, "f" then the flag
+    // or "v" when it takes a value. the help flags are options too
+    void completions(std::string& out, char help_short, const char* help_long) const;
+};
+
+
+// Help rendered at build time, one block per subcommand path (see
+// tools/clikit.bzl). Paths are as HelpMap::subcommand_path().
+struct EmbeddedHelp {
+    const char* path;
+    const char* text;
+    std::size_t size;
+    // HelpMap::completions() at the path
+    const char* complete = nullptr;
+    std::size_t complete_size = 0;
+};
+
+// makes `table`, sorted by path, the help printed by Parsers instead of
+// what they register. called by the generated source before main(). a
+// null table goes back to dynamic help
+bool embed_help(const EmbeddedHelp* table, std::size_t n);
+
+// the embedded block for `path`, or nullptr
+const EmbeddedHelp* find_embedded_help(const char* path);
+
+// set to EMBED_HELP_VALUE in the environment of a program while its help is
+// generated, making Parser::print() describe the subcommands for
+// tools/embed_help. any other value is ignored, so a stray variable in a
+// user's environment cannot change what a program prints
+static const char* const EMBED_HELP_ENV = "CLIKIT_EMBED_HELP";
+static const char* const EMBED_HELP_VALUE = "clikit-embed-help-v1";
+
+
+//-------------------------------------------------------------------------
+// shell completion
+//-------------------------------------------------------------------------
+
+// "PROG --__complete INDEX WORD..." writes the candidates for WORD[INDEX],
+// one per line, where the WORDs are the command line as the shell split it,
+// program name first. nothing is written where only the shell can help,
+// i.e. for values and positionals, so it falls back to completing files.
+//
+// "PROG --__completion SHELL" writes the script that hooks this up for
+// bash, zsh or fish, i.e. `source <(PROG --__completion bash)`
+static const char* const COMPLETE_FLAG = "--__complete";
+static const char* const COMPLETION_SCRIPT_FLAG = "--__completion";
+
+struct CompletionRequest {
+    const char** words = nullptr;
+    std::size_t count = 0;
+    std::size_t index = 0;
+    // the shell asked for by COMPLETION_SCRIPT_FLAG, words[0] is the program
+    const char* shell = nullptr;
+
+    // fills in the request from argv, returning whether argv is one
+    bool parse(std::size_t argc, const char** argv);
+
+    // shells leave off an empty last word
+    const char* current() const { return (index < count) ? words[index] : ""; }
 };
 
+// the candidates (or the script) for `req` from the embedded completion
+// specs (see EmbeddedHelp), returning false when there are none
+bool complete(const CompletionRequest& req, std::string& out);
+
+// answers a completion request in argv from the embedded specs without
+// running the parser chain, or returns false to leave it to the Parser.
+// call it first thing in main(), unless the parser uses dynamic_help():
+//
+//     if (cli::complete(argc, argv)) { return 0; }
+bool complete(std::size_t argc, const char** argv);
+
+// the completion script for `program` in `shell` ("bash", "zsh" or
+// "fish"), empty for any other
+std::string completion_script(const char* shell, const char* program);
+
 
 //-------------------------------------------------------------------------
 // parsing
@@ -554,9 +1434,34 @@ public:
 struct ParseDesc {
     bool is_short = false;
     bool is_long = false;
-    std::uint16_t len = 0;
-    std::uint16_t eq_offset = 0;
-    std::uint16_t runs_remaining = 0;
+    bool is_help = false; // set by classify_args
+    std::uint32_t len = 0;
+    std::uint32_t eq_offset = 0;
+    std::uint32_t runs_remaining = 0;
+
+    // for short args, a bit per short_slot() present in the run and a
+    // bit per slot present more than once, so most matches are a bit test
+    std::uint64_t shorts = 0;
+    std::uint64_t repeats = 0;
+
+    ParseDesc() = default;
+
+    // from a length and first '=' offset (0 if none) that are already known
+    ParseDesc(const char* arg, std::size_t length, std::size_t first_eq) {
+        len = length;
+        if ( (len>=3) and (arg[0] == '-') and (arg[1] == '-') ) {
+            is_long = true;
+        } else if ( (len>=2) and (arg[0] == '-') ) {
+            is_short = true;
+        }
+
+        if (is_positional()) {
+            return;
+        }
+
+        eq_offset = first_eq;
+        init_runs(arg);
+    }
 
     ParseDesc(const char* arg) {
         len = strlen(arg);
@@ -584,30 +1489,251 @@ struct ParseDesc {
             }
         }
 
-        // argument types that support the '=' separator
-        // cannot have runs, so that defaults to 0. otherwise
-        // we use the len minus the '-'
-        runs_remaining = (eq_offset ? 0 : len-1);
+        init_runs(arg);
     }
 
+    // fills the run masks and counts every short in the run (up to any '=')
+    // as remaining. long args are a single flag
+    void init_runs(const char* arg);
+
     bool is_positional() const;
     std::size_t matches(const char* arg, char s) const;
     bool matches(const char* arg, const char* l) const;
+
+    // length of the flag name without leading dashes or '=value'
+    std::size_t name_len() const;
 };
 
 
+// The ParseDesc of every arg in a Context, stored as a structure of arrays.
+// The classification bits tested while walking argv are packed a byte per
+// arg, and the lengths and offsets only needed once an arg matches live in
+// their own 32-bit arrays.
+class ArgTable {
+public:
+    static const std::uint8_t SHORT = 1 << 0;
+    static const std::uint8_t LONG = 1 << 1;
+    static const std::uint8_t HELP = 1 << 2;
+
+    // one arg of the table, answering like its ParseDesc
+    class Row {
+    protected:
+        const ArgTable* _table;
+        std::size_t _i;
+
+    public:
+        Row(const ArgTable* table, std::size_t i) : _table(table), _i(i) {}
+
+        bool is_short() const { return _table->_kind[_i] & SHORT; }
+        bool is_long() const { return _table->_kind[_i] & LONG; }
+        bool is_help() const { return _table->_kind[_i] & HELP; }
+        bool is_positional() const { return not (_table->_kind[_i] & (SHORT | LONG)); }
+        std::size_t len() const { return _table->_len[_i]; }
+        std::size_t eq_offset() const { return _table->_eq_offset[_i]; }
+
+        std::size_t matches(const char* arg, char s) const { return _table->matches(_i, arg, s); }
+        bool matches(const char* arg, const char* l) const { return _table->matches(_i, arg, l); }
+        std::size_t name_len() const { return _table->name_len(_i); }
+    };
 
-class Context {
 protected:
-    BitSet _argset;
-    std::vector<ParseDesc> _argdesc;
+    ArenaVector<std::uint8_t> _kind;
+    ArenaVector<std::uint32_t> _len;
+    ArenaVector<std::uint32_t> _eq_offset;
+    ArenaVector<std::uint32_t> _runs_remaining;
+    ArenaVector<std::uint64_t> _shorts;
+    ArenaVector<std::uint64_t> _repeats;
+
+public:
+    explicit ArgTable(Arena* arena = nullptr)
+        : _kind(arena)
+        , _len(arena)
+        , _eq_offset(arena)
+        , _runs_remaining(arena)
+        , _shorts(arena)
+        , _repeats(arena)
+    {}
 
-    std::size_t _argc;
-    const char** _argv;
+    // resizes to `n` args, keeping allocated storage. entries are
+    // unspecified until set()
+    void resize(std::size_t n);
+    std::size_t size() const { return _kind.size(); }
 
-    std::size_t _level;
-    bool _chain_ended;
-    bool _help;
+    // stores `d` at `i`. distinct `i` may be set from different threads
+    void set(std::size_t i, const ParseDesc& d);
+    // gathers the entry at `i` back into a ParseDesc
+    ParseDesc get(std::size_t i) const;
+
+    Row operator[](std::size_t i) const { return Row(this, i); }
+
+    bool is_long(std::size_t i) const { return _kind[i] & LONG; }
+    bool is_help(std::size_t i) const { return _kind[i] & HELP; }
+    std::size_t eq_offset(std::size_t i) const { return _eq_offset[i]; }
+    std::uint64_t shorts(std::size_t i) const { return _shorts[i]; }
+
+    // see ParseDesc
+    std::size_t matches(std::size_t i, const char* arg, char s) const;
+    bool matches(std::size_t i, const char* arg, const char* l) const;
+    std::size_t name_len(std::size_t i) const;
+
+    // takes up to `n` flags from the run at `i`, returning how many remain
+    std::size_t take_runs(std::size_t i, std::size_t n);
+};
+
+
+// Classifies argv[0, argc) into `desc`, flagging help args with is_help.
+// Each arg's length and first '=' are found in a single (SIMD where
+// available) pass, and very large argv are split across up to `threads`
+// threads (0 picks based on the hardware).
+void classify_args(
+    std::size_t argc, const char** argv,
+    char help_short, const char* help_long,
+    ParseDesc* desc,
+    std::size_t threads = 0
+);
+void classify_args(
+    std::size_t argc, const char** argv,
+    char help_short, const char* help_long,
+    std::vector<ParseDesc>& desc,
+    std::size_t threads = 0
+);
+void classify_args(
+    std::size_t argc, const char** argv,
+    char help_short, const char* help_long,
+    ArgTable& table,
+    std::size_t threads = 0
+);
+
+// args per thread below which classify_args does not bother with threads
+static const std::size_t CLASSIFY_ARGS_PER_THREAD = 1 << 15;
+
+// Expands "@path" arguments into the tokens of the file at path, the way
+// compilers read response files. Tokens are separated by whitespace and
+// may be quoted with '' or "", and a backslash escapes the next character.
+// Response files may reference other response files.
+//
+// Each file is mapped privately and tokenized in place, so the expanded
+// argv points into the mappings and is only valid while this lives (and
+// until the next expand() or clear()).
+class ResponseFiles {
+protected:
+    struct Mapping {
+        void* addr;
+        std::size_t length;
+    };
+
+    std::vector<Mapping> _maps;
+    std::vector<const char*> _argv;
+
+    Error add(const char* arg, std::size_t depth);
+    void unmap();
+
+public:
+    // limit on response files referencing response files, catching cycles
+    static const std::size_t MAX_DEPTH = 16;
+
+    ResponseFiles() = default;
+    ResponseFiles(const ResponseFiles&) = delete; // no copy
+    ResponseFiles& operator=(const ResponseFiles&) = delete; // no copy
+    ResponseFiles(ResponseFiles&& o) noexcept;
+    ResponseFiles& operator=(ResponseFiles&& o) noexcept;
+    ~ResponseFiles() { unmap(); }
+
+    // true if any arg would be expanded
+    static bool any(std::size_t argc, const char** argv);
+
+    // replaces the expansion with that of `argv`. fails when a file cannot
+    // be read or files nest deeper than MAX_DEPTH, with the index of the
+    // top level "@path" arg that led to it
+    Error expand(std::size_t argc, const char** argv);
+
+    // unmaps the files and drops the expansion
+    void clear();
+
+    std::size_t argc() const { return _argv.size(); }
+    const char** argv() { return _argv.data(); }
+};
+
+// Maps short chars and long names to the argv positions carrying them.
+// Built once per Context so each registration only visits the slots that
+// can possibly match it, rather than rescanning every remaining argument.
+class ArgIndex {
+protected:
+    // shorts are bucketed by short_slot(), each bucket in argv order
+    std::size_t _short_offsets[NUM_SHORTS + 1] = {};
+    ArenaVector<std::size_t> _shorts;
+
+    // long args are grouped by name. _table is an open addressed hash of
+    // names to group+1 (0 is empty), and each group's positions sit in
+    // argv order at _longs[begin, end)
+    struct LongGroup {
+        std::size_t first; // position of the first arg with this name
+        std::uint64_t hash;
+        std::size_t begin;
+        std::size_t end;
+    };
+    ArenaVector<LongGroup> _groups;
+    ArenaVector<std::uint32_t> _table;
+    ArenaVector<std::uint32_t> _group_of; // group of each long, in argv order
+    ArenaVector<std::size_t> _longs;
+
+    // group for `l[0:n]` with hash `h`, or nullptr
+    const LongGroup* find_group(
+        const char** argv, const ArgTable& args,
+        const char* l, std::size_t n, std::uint64_t h
+    ) const;
+    void grow_table();
+
+public:
+    ArgIndex(Arena* arena = nullptr)
+        : _shorts(arena)
+        , _groups(arena)
+        , _table(arena)
+        , _group_of(arena)
+        , _longs(arena)
+    {}
+
+    // (re)builds the index, reusing any storage from a previous build
+    void build(std::size_t argc, const char** argv, const ArgTable& args);
+
+    // appends every position matching the short or long name to `out`
+    // in argv order. long names keep the prefix semantics of
+    // ParseDesc::matches (i.e. "--verb" matches "verbose").
+    void find(
+        const char** argv, const ArgTable& args,
+        char s, const char* l,
+        ArenaVector<std::size_t>& out
+    ) const;
+};
+
+
+
+class Context {
+protected:
+    BitSet _argset;
+    Arena* _arena = nullptr;
+    ArgTable _args;
+    ArgIndex _index;
+    ArenaVector<std::size_t> _matches; // scratch for find()
+
+    // names registered so far, to suggest in place of unknown args
+    ArenaVector<const char*> _known_longs;
+    ArenaVector<const char*> _known_subs;
+    ArenaVector<std::pair<const SubcommandDesc*, std::size_t>> _known_tables;
+
+    std::size_t _argc = 0;
+    const char** _argv = nullptr;
+    char _help_short = 'h';
+    const char* _help_long = "help";
+    ResponseFiles _responses;
+
+    std::size_t _level = 0;
+    bool _chain_ended = false;
+    bool _help = false;
+
+    Error _error;
+    OnError _on_error = DEFAULT_ON_ERROR;
+    Diagnostics _diagnostics;
 
 public:
     class iterator {
@@ -615,7 +1741,7 @@ public:
         struct value {
             std::size_t index;
             const char* c_str;
-            ParseDesc& desc;
+            ArgTable::Row desc;
         };
 
         using self_type = iterator;
@@ -630,22 +1756,22 @@ public:
         const BitSet::unset_iterator _end;
 
         const char** _argv;
-        std::vector<ParseDesc>& _desc;
+        const ArgTable* _args;
 
 
     public:
         iterator() = delete;
         iterator(
-            const char** argv, std::vector<ParseDesc>& desc,
+            const char** argv, const ArgTable* args,
             const BitSet::unset_iterator begin, const BitSet::unset_iterator end
         )
             : _iter(begin)
             , _end(end)
             , _argv(argv)
-            , _desc(desc)
+            , _args(args)
         {}
-        iterator(const char** argv, std::vector<ParseDesc>& desc, const BitSet& set)
-            : iterator(argv, desc, set.unset_begin(), set.unset_end())
+        iterator(const char** argv, const ArgTable* args, const BitSet& set)
+            : iterator(argv, args, set.unset_begin(), set.unset_end())
         {}
         self_type operator++() {
             _iter++;
@@ -657,7 +1783,7 @@ public:
             return i;
         }
         value_type operator*() const {
-            return value{*_iter, _argv[*_iter], _desc[*_iter]};
+            return value{*_iter, _argv[*_iter], (*_args)[*_iter]};
         }
         bool operator==(const self_type& rhs) {
             return (_iter == rhs._iter);
@@ -667,70 +1793,358 @@ public:
         }
 
         const char* c_str() const { return _argv[*_iter]; }
-        ParseDesc& desc() const { return _desc[*_iter]; }
+        ArgTable::Row desc() const { return (*_args)[*_iter]; }
         std::size_t index() const { return *_iter; }
     };
 
+    // iterates the indexed matches of a registration, skipping any that
+    // were consumed since the lookup (i.e. taken as another arg's value)
+    class match_iterator {
+    public:
+        using self_type = match_iterator;
+        using value_type = iterator::value_type;
+
+    protected:
+        Context* _ctx;
+        const std::size_t* _cursor;
+        const std::size_t* _end;
+
+        void skip_used() {
+            while ((_cursor != _end) and _ctx->_argset.is_set(*_cursor)) {
+                _cursor++;
+            }
+        }
+
+    public:
+        match_iterator() = delete;
+        match_iterator(Context* ctx, const std::size_t* begin, const std::size_t* end)
+            : _ctx(ctx)
+            , _cursor(begin)
+            , _end(end)
+        {
+            skip_used();
+        }
+        self_type operator++() {
+            _cursor++;
+            skip_used();
+            return *this;
+        }
+        value_type operator*() const {
+            return value_type{*_cursor, _ctx->_argv[*_cursor], _ctx->_args[*_cursor]};
+        }
+        bool operator==(const self_type& rhs) const {
+            return _cursor == rhs._cursor;
+        }
+        bool operator!=(const self_type& rhs) const {
+            return not (*this == rhs);
+        }
+    };
+
+    class match_range {
+    protected:
+        Context* _ctx;
+        const std::size_t* _begin;
+        const std::size_t* _end;
+
+    public:
+        match_range(Context* ctx, const std::size_t* begin, const std::size_t* end)
+            : _ctx(ctx), _begin(begin), _end(end)
+        {}
+
+        match_iterator begin() const { return match_iterator(_ctx, _begin, _end); }
+        match_iterator end() const { return match_iterator(_ctx, _end, _end); }
+        std::size_t size() const { return _end - _begin; }
+    };
+
 public:
-    Context() = default;
+    // storage comes from `arena` when given, otherwise the heap
+    explicit Context(Arena* arena = nullptr)
+        : _argset(arena)
+        , _arena(arena)
+        , _args(arena)
+        , _index(arena)
+        , _matches(arena)
+        , _known_longs(arena)
+        , _known_subs(arena)
+        , _known_tables(arena)
+    {}
     Context(const Context&) = delete; // no copy
     Context& operator=(const Context&) = delete; // no copy
     Context(Context&&) = default; // default move
     Context& operator=(Context&&) = default; // default move
 
-    Context(std::size_t argc, const char** argv, char help_short='h', const char* help_long="help")
-        : _argset(argc)
-        , _argc(argc)
-        , _argv(argv)
-        , _level(0)
-        , _chain_ended(false)
-        , _help(false)
+    Context(
+        std::size_t argc, const char** argv,
+        char help_short='h', const char* help_long="help",
+        Arena* arena = nullptr
+    )
+        : Context(arena)
     {
-        _argdesc.reserve(argc);
-        for (std::size_t i = 0; i < argc; i++) {
-            _argdesc.emplace_back(argv[i]);
-
-            if (not _argdesc.back().is_positional()) {
-                if (
-                    _argdesc.back().matches(_argv[i], help_short)
-                    or _argdesc.back().matches(_argv[i], help_long)
-                ) {
-                    _help = true;
-                    _argset.set(i);
-                }
-            }
-        }
+        reset(argc, argv, help_short, help_long);
     }
 
-    iterator begin() {
-        return iterator(_argv, _argdesc, _argset);
-    }
-    iterator end() {
-        return iterator(_argv, _argdesc, _argset.unset_end(), _argset.unset_end());
-    }
+    // re-targets the context at a new argv, keeping allocated capacity
+    void reset(std::size_t argc, const char** argv, char help_short='h', const char* help_long="help");
 
-    void used(std::size_t i) {
-        _argset.set(i);
-    }
+    // drops all storage, so the arena behind it can be rewound, and unmaps
+    // any response files
+    void release();
 
-    std::size_t remaining() const {
+    char help_short() const { return _help_short; }
+    const char* help_long() const { return _help_long; }
+
+    //---------------------------------------------------------------------
+    // errors
+    //---------------------------------------------------------------------
+
+    // kept across reset(). Throw is unavailable without exceptions
+    void on_error(OnError mode) {
+#if !CLIKIT_EXCEPTIONS
+        if (mode == OnError::Throw) {
+            mode = OnError::Stop;
+        }
+#endif
+        _on_error = mode;
+    }
+
+    // records `e`, or raises it when errors are thrown. error() keeps the
+    // first, and Collect adds each to the diagnostics. returns whether the
+    // matcher should carry on past the offending arg, i.e. when collecting
+    bool fail(Error e) {
+        // context indices skip the program name, error indices do not
+        if (e.index != Error::npos) {
+            e.index++;
+        }
+        if (_on_error == OnError::Throw) {
+            e.raise();
+        }
+        if (not _error) {
+            _error = e;
+        }
+        if (_on_error == OnError::Collect) {
+            _diagnostics.add(e);
+            return true;
+        }
+        return false;
+    }
+
+    bool failed() const { return bool(_error); }
+    // failed and not collecting, so the chain has nothing more to do
+    bool stopped() const { return failed() and (_on_error != OnError::Collect); }
+    bool collecting() const { return _on_error == OnError::Collect; }
+    const Error& error() const { return _error; }
+    const Diagnostics& diagnostics() const { return _diagnostics; }
+
+    // writes the args not yet used, each preceded by a space
+    void print_unused(std::ostream& s) const;
+
+    // replaces "@path" args with the contents of their response files, as
+    // if they had been given on the command line. must precede any take_*.
+    // values taken from the files borrow from this context, and are valid
+    // until release_response_files(), release() or its destruction
+    void expand_response_files();
+    void release_response_files() { _responses.clear(); }
+
+    iterator begin() {
+        return iterator(_argv, &_args, _argset);
+    }
+    iterator end() {
+        return iterator(_argv, &_args, _argset.unset_end(), _argset.unset_end());
+    }
+
+    // unused args matching either the short or the long name, in argv order.
+    // the range is invalidated by the next call to find()
+    match_range find(char s, const char* l) {
+        if (l and *l) {
+            _known_longs.push_back(l);
+        }
+        _matches.clear();
+        _index.find(_argv, _args, s, l, _matches);
+        return match_range(this, _matches.data(), _matches.data() + _matches.size());
+    }
+
+    void used(std::size_t i) {
+        _argset.set(i);
+    }
+
+    // subcommands at the current level that were not given, whose names
+    // are suggested for unknown positionals. forgotten on entering one
+    void known_subcommand(const char* name) {
+        _known_subs.push_back(name);
+    }
+    void known_subcommands(const SubcommandDesc* subs, std::size_t n) {
+        _known_tables.emplace_back(subs, n);
+    }
+    void forget_subcommands() {
+        _known_subs.clear();
+        _known_tables.clear();
+    }
+
+    // the known long flag (for long args) or subcommand (for positionals)
+    // nearest the arg at `i`, or nullptr if none is near enough
+    const char* suggest(std::size_t i) const;
+
+    // takes `n` flags from the run at `i`, marking it used once all are taken
+    void consume_run(std::size_t i, std::size_t n);
+
+    std::size_t remaining() const {
         return _argset.remaining();
     }
 
-    // returns nullptr if there are no more args to take
-    const char* get_arg_or_eq(std::size_t i) {
-        if (_argdesc[i].eq_offset) {
-            return &_argv[i][_argdesc[i].eq_offset + 1];
+    // the value of the arg at `i`, after its '=' or else the next arg, or
+    // a null view if there are no more args to take. `at` is set to the
+    // index of the arg holding the value
+    StringView get_arg_or_eq(std::size_t i, std::size_t& at) {
+        if (auto eq = _args.eq_offset(i)) {
+            at = i;
+            return StringView(&_argv[i][eq + 1], _args[i].len() - eq - 1);
         }
 
         if (i == (_argset.total()-1)) {
-            return nullptr;
+            return StringView();
+        }
+
+        at = i + 1;
+        _argset.set(at);
+        return StringView(_argv[at], _args[at].len());
+    }
+
+    //---------------------------------------------------------------------
+    // matching
+    //
+    // consume the unused args matching a registration, in argv order.
+    // shared by Parser and Spec so both follow the same rules.
+    //---------------------------------------------------------------------
+
+    // sets `into` on the first match and fails on any further match
+    void take_flag(char s, const char* l, bool& into, bool invert);
+
+    // returns the number of times the short (including runs) or long was given
+    std::size_t take_count(char s, const char* l);
+
+    // calls `set` with the value of the single match, returning whether there
+    // was one. `set` returns the ErrorCode of converting the value
+    template <typename Fn>
+    bool take_arg(char s, const char* l, Fn&& set) {
+        bool has_seen = false;
+        for (auto& arg : find(s, l)) {
+            // it matched, so is it a dupe?
+            if (has_seen) {
+                if (not fail(Error(ErrorCode::Duplicate, arg.index, s, l))) {
+                    return false;
+                }
+                // collecting, so drop the dupe and its value
+                std::size_t at;
+                get_arg_or_eq(arg.index, at);
+                used(arg.index);
+                continue;
+            }
+            has_seen = true;
+
+            // if short, disallow runs
+            if (arg.desc.is_short() and (arg.desc.matches(arg.c_str, s) > 1)) {
+                if (not fail(Error(ErrorCode::Run, arg.index, s, l))) {
+                    return false;
+                }
+                used(arg.index);
+                continue;
+            }
+
+            // get the arg to construct with this may be the next
+            // argument in argv or it could be an '=' sep
+            std::size_t at = arg.index;
+            auto ctor_arg = get_arg_or_eq(arg.index, at);
+
+            // mark this arg as done regardless of the eq separator or not
+            used(arg.index);
+
+            if (ctor_arg.data() == nullptr) {
+                if (not fail(Error(ErrorCode::MissingValue, arg.index, s, l))) {
+                    return false;
+                }
+                continue;
+            }
+
+            auto err = set(ctor_arg);
+            if ((err != ErrorCode::None) and not fail(Error(err, at, s, l, ctor_arg.data()))) {
+                return false;
+            }
+        }
+        return has_seen;
+    }
+
+    // calls `each` with the value of every match and the index of the arg
+    // holding it. a value for which it does not return ErrorCode::None
+    // fails, ending the list unless collecting
+    template <typename Fn>
+    void take_list(char s, const char* l, Fn&& each) {
+        take_list(s, l, std::forward<Fn>(each), [](std::size_t) {});
+    }
+    // as above, first calling `reserve` with the number of matches
+    template <typename Fn, typename Reserve>
+    void take_list(char s, const char* l, Fn&& each, Reserve&& reserve) {
+        auto matches = find(s, l);
+        reserve(matches.size());
+        for (auto& arg : matches) {
+            // if short, disallow runs
+            if (arg.desc.is_short() and (arg.desc.matches(arg.c_str, s) > 1)) {
+                if (not fail(Error(ErrorCode::Run, arg.index, s, l))) {
+                    return;
+                }
+                used(arg.index);
+                continue;
+            }
+
+            // get the arg to construct with this may be the next
+            // argument in argv or it could be an '=' sep
+            std::size_t at = arg.index;
+            auto ctor_arg = get_arg_or_eq(arg.index, at);
+
+            // mark this arg as done regardless of the eq separator or not
+            used(arg.index);
+
+            if (ctor_arg.data() == nullptr) {
+                if (not fail(Error(ErrorCode::MissingListValue, arg.index, s, l))) {
+                    return;
+                }
+                continue;
+            }
+
+            auto err = each(ctor_arg, at);
+            if ((err != ErrorCode::None) and not fail(Error(err, at, s, l, ctor_arg.data()))) {
+                return;
+            }
         }
+    }
+
+    // consumes the first unused positional, setting `at` to its index, or
+    // returns a null view when there is none
+    StringView take_positional(std::size_t& at);
+
+    // fails if any args were left unused
+    void validate();
+
+    // calls `each` with every unused arg, failing if any are not positional
+    // or `each` returns an error
+    template <typename Fn>
+    void take_all_positionals(Fn&& each) {
+        for (auto& a : *this) {
+            used(a.index);
+            if (not a.desc.is_positional()) {
+                if (not fail(Error(ErrorCode::UnknownArgument, a.index, 0, suggest(a.index), a.c_str))) {
+                    return;
+                }
+                continue;
+            }
 
-        _argset.set(i + 1);
-        return _argv[i + 1];
+            auto err = each(StringView(a.c_str, a.desc.len()));
+            if ((err != ErrorCode::None) and not fail(Error(err, a.index, 0, nullptr, a.c_str))) {
+                return;
+            }
+        }
     }
 
+
     void next_level() {
         _level++;
     }
@@ -741,7 +2155,7 @@ public:
         _chain_ended = true;
     }
     bool should_continue(std::size_t curr_level, bool is_subcommand = false) const {
-        if (_chain_ended) {
+        if (_chain_ended or stopped()) {
             return false;
         }
 
@@ -755,34 +2169,60 @@ public:
     bool wants_help() const {
         return _help;
     }
+    // parse as if asked for help without a help arg, i.e. to complete it
+    void help_only() {
+        _help = true;
+    }
 };
 
 
+// a compile-time subcommand table, see below
+template <std::size_t N>
+class Subcommands;
+
 class Parser {
 protected:
+    // internal storage comes from _arena, which is ours unless given one
+    std::unique_ptr<Arena> _own_arena;
+    Arena* _arena = nullptr;
+
     Context _ctx;
 
     bool _in_group;
     std::size_t _level;
 
     bool _help_shortcircuit = true;
-    std::unique_ptr<HelpMap> _help;
-
-protected:
-
-    template <typename Into>
-    auto handle_positional(Into& into, const char* arg)
-    -> typename std::enable_if<
-        std::is_constructible<typename Into::value_type, const char*>::value,
-    void>::type
-    {
-        into.emplace_back(arg);
-    }
-    template <typename Into>
-    auto handle_positional(Into& into, const char* arg)
-    -> typename std::enable_if<std::is_constructible<Into, const char*>::value, void>::type
-    {
-        into = Into(arg);
+    ArenaPtr<HelpMap> _help;
+
+    // the embedded help for the subcommand path so far. while set,
+    // registrations are not recorded into _help
+    const EmbeddedHelp* _embedded = nullptr;
+    bool _dynamic_help = false;
+
+    // looks up _embedded for the current subcommand path
+    void find_embedded();
+
+    // set when argv asks for completion rather than to be parsed, in which
+    // case the context holds the words before the one completed, parsed as
+    // if for help, and print() writes the candidates
+    CompletionRequest _complete;
+    bool _completing = false;
+    // the word after the deepest subcommand the chain entered
+    std::size_t _complete_from = 1;
+
+    void begin_completion();
+    void print_completions() const;
+
+    // moves `arg` to the first unused arg, where a subcommand would be,
+    // failing any options before it (as not available to `name`). returns
+    // false if the chain should stop there
+    bool subcommand_arg(const char* name, Context::iterator& arg);
+    // takes `arg` as the subcommand `name` and descends into its level
+    void enter_subcommand(const Context::iterator& arg, const char* name, const char* desc);
+
+    // _help while it records registrations, otherwise nullptr
+    HelpMap* recording() const {
+        return _embedded ? nullptr : _help.get();
     }
 
 public:
@@ -796,19 +2236,66 @@ public:
         std::size_t argc, const char** argv,
         char help_short='h', const char* help_long="help"
     )
-        : _ctx(argc-1, argv+1, help_short, help_long)
+        : Parser(std::unique_ptr<Arena>(new Arena()), nullptr, argc, argv, help_short, help_long)
+    {}
+
+    // allocates from `arena`, which reset() rewinds, so it must not be
+    // shared with anything else that is still in use
+    Parser(
+        Arena& arena,
+        std::size_t argc, const char** argv,
+        char help_short='h', const char* help_long="help"
+    )
+        : Parser(nullptr, &arena, argc, argv, help_short, help_long)
+    {}
+
+protected:
+    Parser(
+        std::unique_ptr<Arena> own, Arena* arena,
+        std::size_t argc, const char** argv,
+        char help_short, const char* help_long
+    )
+        : _own_arena(std::move(own))
+        , _arena(_own_arena ? _own_arena.get() : arena)
+        , _ctx(argc-1, argv+1, help_short, help_long, _arena)
         , _in_group(false)
         , _level(0)
         , _help_shortcircuit(true)
     {
+        if (_complete.parse(argc, argv)) {
+            begin_completion();
+        }
         if (_ctx.wants_help()) {
-            _help = std::unique_ptr<HelpMap>(new HelpMap());
+            _help = arena_new<HelpMap>(_arena, _arena);
+            find_embedded();
         }
     }
 
+public:
+    // parses a new argv with the same help flags, as if newly constructed,
+    // after rewinding the arena. once the arena has grown to fit, parsing
+    // again does not allocate
+    Parser& reset(std::size_t argc, const char** argv);
+
     bool wants_help() const;
     void print() const;
 
+    // how errors are reported (see OnError), kept across reset()
+    Parser& on_error(OnError mode) {
+        _ctx.on_error(mode);
+        return *this;
+    }
+
+    // the first error when not thrown, see OnError::Stop
+    const Error& error() const { return _ctx.error(); }
+    bool failed() const { return _ctx.failed(); }
+
+    // every error, see OnError::Collect
+    const Diagnostics& diagnostics() const { return _ctx.diagnostics(); }
+
+    // Error, then Help, else Ok
+    ParseStatus status() const;
+
     // exit the current group/level/subcommand
     Parser& done();
 
@@ -824,33 +2311,49 @@ public:
     //---------------------------------------------------------------------
 
     Parser& details(const char* name, const char* desc, const char* long_desc="") {
-        if (_ctx.wants_help()) {
-            _help->_desc = Description(name, desc, long_desc);
+        if (auto help = recording()) {
+            help->details(name, desc, long_desc);
         }
 
         return *this;
     }
 
     Parser& version(const char* v) {
-        if (_ctx.wants_help()) {
-            _help->_app_version = v;
+        if (auto help = recording()) {
+            help->_app_version = v;
         }
 
         return *this;
     }
 
     Parser& indent_width(std::uint8_t w) {
-        if (_ctx.wants_help()) {
-            _help->_indent_width = w;
+        if (auto help = recording()) {
+            help->_indent_width = w;
         }
         return *this;
     }
 
+    // help for options registered at runtime (i.e. from other args) cannot
+    // be rendered at build time, so always builds it from the chain rather
+    // than printing embedded help. must precede details() and any registration
+    Parser& dynamic_help() {
+        _dynamic_help = true;
+        _embedded = nullptr;
+        return *this;
+    }
+
     Parser& disable_help_shortcircuit() {
         _help_shortcircuit = false;
         return *this;
     }
 
+    // expands "@path" args into the tokens of their response files (see
+    // ResponseFiles). must be called before any argument is registered.
+    // the parser owns the mappings: StringView and const char* values bound
+    // to their tokens borrow from it, and are only valid until it is reset()
+    // or destroyed
+    Parser& expand_response_files();
+
     //---------------------------------------------------------------------
     // flag
     //---------------------------------------------------------------------
@@ -862,30 +2365,13 @@ public:
         }
 
         if (wants_help()) {
-            _help->add_arg(_in_group, s, l, "", desc);
+            if (auto help = recording()) { help->add_arg(_in_group, s, l, "", desc); }
             if (_help_shortcircuit) {
                 return *this;
             }
         }
 
-        bool has_seen = false;
-        for (auto& arg : _ctx) {
-            if (arg.desc.is_positional()) { continue; }
-
-            auto run_count = arg.desc.matches(arg.c_str, s);
-            if (run_count or arg.desc.matches(arg.c_str, l)) {
-                // flags can only be set once so if we've seen it already, bail
-                if (has_seen or (run_count > 1)) {
-                    std::stringstream ss;
-                    ss << "flag argument '" << arg_string(s, l) << "' provided more than once";
-                    throw ParseError(ss.str());
-                }
-
-                has_seen = true;
-                into = not invert;
-                _ctx.used(arg.index);
-            }
-        }
+        _ctx.take_flag(s, l, into, invert);
         return *this;
     }
     Parser& flag(char s, const char* desc, bool& into, bool invert=false) {
@@ -908,29 +2394,13 @@ public:
         }
 
         if (wants_help()) {
-            _help->add_arg(_in_group, s, l, "", desc);
+            if (auto help = recording()) { help->add_arg(_in_group, s, l, "", desc); }
             if (_help_shortcircuit) {
                 return *this;
             }
         }
 
-        for (auto& arg : _ctx) {
-            if (arg.desc.is_positional()) { continue; }
-
-            auto run_count = arg.desc.matches(arg.c_str, s);
-            if (arg.desc.is_short and run_count) {
-                into += run_count;
-                arg.desc.runs_remaining -= run_count;
-            } else if (arg.desc.is_long and arg.desc.matches(arg.c_str, l)) {
-                into += 1;
-            } else {
-                continue;
-            }
-
-            if (arg.desc.runs_remaining == 0) {
-                _ctx.used(arg.index);
-            }
-        }
+        into += _ctx.take_count(s, l);
         return *this;
     }
     template <typename T>
@@ -958,57 +2428,19 @@ public:
         }
 
         if (wants_help()) {
-            _help->add_arg(_in_group, s, l, arg_desc, desc);
+            if (auto help = recording()) { help->add_arg(_in_group, s, l, arg_desc, desc, true); }
             if (_help_shortcircuit) {
                 return *this;
             }
         }
 
-        bool has_seen = false;
-        for (auto& arg : _ctx) {
-            if (arg.desc.is_positional()) { continue; }
-
-            auto run_count = arg.desc.matches(arg.c_str, s);
-            bool match_long = arg.desc.matches(arg.c_str, l);
-
-            // expect it to match, otherwise skip
-            if (not (run_count or match_long)) {
-                continue;
-            }
-
-            // it matched, so is it a dupe?
-            if (has_seen) {
-                std::stringstream ss;
-                ss << "argument '" << arg_string(s, l) << "' cannot be provided multiple times";
-                throw ParseError(ss.str());
-            }
-
-            // if short, disallow runs
-            if (arg.desc.is_short and (run_count > 1)) {
-                std::stringstream ss;
-                ss << "argument '" << s << "' cannot be given in a run";
-                throw ParseError(ss.str());
-            }
-
-            // get the arg to construct with this may be the next
-            // argument in argv or it could be an '=' sep
-            auto ctor_arg = _ctx.get_arg_or_eq(arg.index);
-            if (ctor_arg == nullptr) {
-                std::stringstream ss;
-                ss << "no argument value provided to '" << arg_string(s, l) << "'";
-                throw ParseError(ss.str());
-            }
-
-            // construct the value
-            into = From<T>(ctor_arg);
-
-            // mark this arg as done regardless of the eq separator or not
-            _ctx.used(arg.index);
-            has_seen = true;
-        }
+        // construct the value
+        bool has_seen = _ctx.take_arg(s, l, [&](StringView ctor_arg) {
+            return TryFrom(ctor_arg, into);
+        });
 
         if (not has_seen and (req == ArgReq::Required) and not wants_help()) {
-            throw MissingArgumentError(s, l);
+            _ctx.fail(Error(ErrorCode::MissingArgument, Error::npos, s, l));
         }
 
         return *this;
@@ -1041,54 +2473,84 @@ public:
         }
 
         if (wants_help()) {
-            _help->add_arg(_in_group, s, l, arg_desc, desc);
+            if (auto help = recording()) { help->add_arg(_in_group, s, l, arg_desc, desc, true); }
             if (_help_shortcircuit) {
                 return *this;
             }
         }
 
-        for (auto& arg : _ctx) {
-            if (arg.desc.is_positional()) { continue; }
-
-            auto run_count = arg.desc.matches(arg.c_str, s);
-            bool match_long = arg.desc.matches(arg.c_str, l);
+        // emplace each arg into the container
+        _ctx.take_list(s, l, [&](StringView ctor_arg, std::size_t) {
+            return Emplace(into, ctor_arg);
+        }, [&](std::size_t n) {
+            Reserve(into, n);
+        });
 
-            // expect it to match, otherwise skip
-            if (not (run_count or match_long)) {
-                continue;
-            }
+        return *this;
+    }
+    template <typename T>
+    Parser& list(char s, const char* desc, T& into) {
+        return list(s, nullptr, desc, into);
+    }
+    template <typename T>
+    Parser& list(const char* l, const char* desc, T& into) {
+        return list(0, l, desc, into);
+    }
 
-            // if short, disallow runs
-            if (arg.desc.is_short and (run_count > 1)) {
-                std::stringstream ss;
-                ss << "argument '" << s << "' cannot be given in a run";
-                throw ParseError(ss.str());
-            }
+    // collect the values, then convert them on several threads
+    template <typename Into>
+    Parser& list(char s, const char* l, const char* desc, Parallel<Into> into, const char* arg_desc="") {
+        if (not _ctx.should_continue(_level)) {
+            return *this;
+        }
 
-            // get the arg to construct with this may be the next
-            // argument in argv or it could be an '=' sep
-            auto ctor_arg = _ctx.get_arg_or_eq(arg.index);
-            if (ctor_arg == nullptr) {
-                std::stringstream ss;
-                ss << "no argument value provided to list '" << arg_string(s, l) << "'";
-                throw ParseError(ss.str());
+        if (wants_help()) {
+            if (auto help = recording()) { help->add_arg(_in_group, s, l, arg_desc, desc, true); }
+            if (_help_shortcircuit) {
+                return *this;
             }
+        }
 
-            // emplace the arg into the container
-            Emplace(into, ctor_arg);
-
-            // mark this arg as done regardless of the eq separator or not
-            _ctx.used(arg.index);
+        // the values, and where in argv each was for reporting a failure
+        std::vector<const char*> args;
+        std::vector<std::size_t> at;
+        _ctx.take_list(s, l, [&](StringView arg, std::size_t i) {
+            args.push_back(arg.data());
+            at.push_back(i);
+            return ErrorCode::None;
+        }, [&](std::size_t n) {
+            args.reserve(n);
+            at.reserve(n);
+        });
+
+        auto err = ErrorCode::None;
+        auto failed = into.convert(args, err);
+        if (failed < args.size()) {
+            _ctx.fail(Error(err, at[failed], s, l, args[failed]));
         }
 
         return *this;
     }
-    template <typename T>
-    Parser& list(char s, const char* desc, T& into) {
+    template <typename Into>
+    Parser& list(char s, const char* desc, Parallel<Into> into) {
         return list(s, nullptr, desc, into);
     }
-    template <typename T>
-    Parser& list(const char* l, const char* desc, T& into) {
+    template <typename Into>
+    Parser& list(const char* l, const char* desc, Parallel<Into> into) {
+        return list(0, l, desc, into);
+    }
+
+    // stream values into a (temporary) Sink
+    template <typename T, typename C>
+    Parser& list(char s, const char* l, const char* desc, Sink<T, C>&& into, const char* arg_desc="") {
+        return list(s, l, desc, into, arg_desc);
+    }
+    template <typename T, typename C>
+    Parser& list(char s, const char* desc, Sink<T, C>&& into) {
+        return list(s, nullptr, desc, into);
+    }
+    template <typename T, typename C>
+    Parser& list(const char* l, const char* desc, Sink<T, C>&& into) {
         return list(0, l, desc, into);
     }
 
@@ -1108,44 +2570,24 @@ public:
             return *this;
         }
 
-        auto arg_len = strlen(name);
-
-        // subcommands only operate on the first available arg
-        // so we can just use the iterator
         auto arg = _ctx.begin();
-        if (arg == _ctx.end()) {
-            // we asked for help, but have no positional, so we should add ourself to the help
-            if (wants_help()) {
-                _help->add_subcommand(name, desc);
-            }
+        if (not subcommand_arg(name, arg)) {
             return *this;
         }
-        if (not arg.desc().is_positional()) {
-            std::stringstream ss;
-            ss << "argument '" << arg.c_str() << "' not available at this (sub)command";
-            throw ParseError(ss.str());
-        }
 
         // ... this is not the subcommand you're looking for
-        if ((arg.desc().len != arg_len) or (strncmp(name, arg.c_str(), arg_len) != 0)) {
-            if (wants_help()) {
+        auto arg_len = strlen(name);
+        if ((arg == _ctx.end()) or (arg.desc().len() != arg_len) or (strncmp(name, arg.c_str(), arg_len) != 0)) {
+            _ctx.known_subcommand(name);
+            if (auto help = recording()) {
                 // if we dont change levels and have help arg, add ourselves as a subcommand
-                _help->add_subcommand(name, desc);
+                help->add_subcommand(name, desc);
             }
             return *this;
         }
 
-        into = T(arg.c_str());
-        _ctx.used(arg.index());
-        _ctx.next_level();
-
-        if (wants_help()) {
-            // set this subcommand to be used in the details and usage lines
-            _help->subcommand_details(name, desc);
-            // delete any subcommands we have registered so far
-            _help->clear_subcommands();
-        }
-
+        Assign(into, arg.c_str());
+        enter_subcommand(arg, name, desc);
         return *this;
     }
     template <typename T>
@@ -1170,6 +2612,77 @@ public:
         return *this;
     }
 
+    // Like the overloads above, but the subcommand's own options are
+    // registered by `body`, which is called with this parser only when the
+    // subcommand is entered, so unmatched subcommands build nothing. done()
+    // is called for the subcommand afterwards:
+    //
+    //     parse.subcommand("build", "builds things", cmd, [&](cli::Parser& p) {
+    //         p.flag('v', "verbose", "build verbosity", verbose);
+    //     });
+    template <typename T, typename Body>
+    auto subcommand(const char* name, const char* desc, T& into, Body&& body)
+    -> decltype((void)body(std::declval<Parser&>()), std::declval<Parser&>())
+    {
+        auto level = _ctx.level();
+        this->subcommand(name, desc, into);
+        if (_ctx.level() != level) {
+            body(*this);
+        }
+        return done();
+    }
+
+    // Dispatches on a whole Subcommands table at once: the first unused
+    // arg is looked up with one hash rather than compared with each name,
+    // and `into` is set to the id of the one it names. as with the other
+    // overloads, register that subcommand's options and end with done():
+    //
+    //     std::size_t cmd = COMMANDS.npos;
+    //     parse.subcommand(COMMANDS, cmd);
+    //     switch (cmd) { case 0: parse.flag(...); break; ... }
+    //     parse.done();
+    template <std::size_t N>
+    Parser& subcommand(const Subcommands<N>& table, std::size_t& into) {
+        _level++;
+
+        if (not _ctx.should_continue(_level, true)) {
+            return *this;
+        }
+
+        auto arg = _ctx.begin();
+        if (not subcommand_arg(nullptr, arg)) {
+            return *this;
+        }
+
+        auto id = (arg == _ctx.end()) ? table.npos : table.find(arg.c_str(), arg.desc().len());
+        if (id == table.npos) {
+            _ctx.known_subcommands(table.begin(), table.size());
+            if (auto help = recording()) {
+                for (auto& sub : table) {
+                    help->add_subcommand(sub.name, sub.desc);
+                }
+            }
+            return *this;
+        }
+
+        into = id;
+        enter_subcommand(arg, table[id].name, table[id].desc);
+        return *this;
+    }
+    // As above, calling `body` with this parser and the id entered, if any,
+    // then done()
+    template <std::size_t N, typename Body>
+    auto subcommand(const Subcommands<N>& table, std::size_t& into, Body&& body)
+    -> decltype((void)body(std::declval<Parser&>(), into), std::declval<Parser&>())
+    {
+        auto level = _ctx.level();
+        this->subcommand(table, into);
+        if (_ctx.level() != level) {
+            body(*this, into);
+        }
+        return done();
+    }
+
 
     //---------------------------------------------------------------------
     // group
@@ -1177,12 +2690,13 @@ public:
 
     Parser& group(const char* name, const char* desc="") {
         if (_in_group) {
-            throw InternalError("nested groups are not allowed");
+            _ctx.fail(Error(ErrorCode::NestedGroup, Error::npos, 0, name));
+            return *this;
         }
 
         _in_group = true;
-        if (wants_help()) {
-            _help->new_group(name, desc);
+        if (auto help = recording()) {
+            help->new_group(name, desc);
         }
         return *this;
     }
@@ -1202,64 +2716,791 @@ public:
         }
 
         if (wants_help()) {
-            _help->add_positional(false, req, name, desc);
+            if (auto help = recording()) { help->add_positional(false, req, name, desc); }
             if (_help_shortcircuit) {
                 return *this;
             }
         }
 
-        // looks for the first positional argument and handles it
-        // this used to only operate on the first argument, but there are situations
-        // where this may not match valid usage patterns
-        auto arg = _ctx.begin();
-        for (; arg != _ctx.end() and not arg.desc().is_positional(); arg++) {}
-
-        if (arg == _ctx.end()) {
+        std::size_t at;
+        auto arg = _ctx.take_positional(at);
+        if (arg.data() == nullptr) {
             if (req == ArgReq::Required and not wants_help()) {
-                throw MissingArgumentError(0, name);
+                _ctx.fail(Error(ErrorCode::MissingArgument, Error::npos, 0, name));
             }
             // no arg here
             return *this;
         }
 
-        if (not arg.desc().is_positional()) {
-            std::stringstream ss;
-            ss << "argument '" << arg.c_str() << "' not available at this (sub)command";
-            throw ParseError(ss.str());
+        auto err = Assign(into, arg);
+        if (err != ErrorCode::None) {
+            _ctx.fail(Error(err, at, 0, name, arg.data()));
         }
-
-        handle_positional(into, arg.c_str());
-        _ctx.used(arg.index());
         return *this;
     }
 
     // return void to terminate the chain
-    // does the same as Parser::validate() where an exception is thrown when
+    // does the same as Parser::validate() where an error is raised when
     // not all arguments were consumed.
     template <typename T>
     void all_positionals(const char* name, const char* desc, T& into) {
         // becuase this is a finalizer, we do not consider level
+        if (_ctx.stopped()) {
+            return;
+        }
 
         if (wants_help()) {
-            _help->add_variadic_positional(name, desc);
+            if (auto help = recording()) { help->add_variadic_positional(name, desc); }
             if (_help_shortcircuit) {
                 return;
             }
         }
 
-        for (auto& a : _ctx) {
-            if (not a.desc.is_positional()) {
-                std::stringstream ss;
-                ss << "unknown argument '" << a.c_str << "'";
-                throw ParseError(ss.str());
-            }
-
-            _ctx.used(a.index);
-            Emplace(into, a.c_str);
+        Reserve(into, _ctx.remaining());
+        _ctx.take_all_positionals([&](StringView arg) {
+            return Emplace(into, arg);
+        });
+    }
+    template <typename T, typename C>
+    void all_positionals(const char* name, const char* desc, Sink<T, C>&& into) {
+        all_positionals(name, desc, into);
+    }
+};
+
+
+
+//-------------------------------------------------------------------------
+// compiled spec
+//-------------------------------------------------------------------------
+
+// An option set described once and compiled for parsing many argv vectors.
+//
+// Parser discovers options by running its chain against a single argv.
+// Spec records the same registrations once (string lengths, help, converters)
+// and replays them against each argv, writing into members of a per-call
+// `Out`. A compiled Spec is never mutated by parse(), so one instance can be
+// shared between threads as long as each uses its own `Out` and Scratch.
+//
+//     auto spec = cli::Spec<Options>::Builder()
+//         .details("tool", "does things")
+//         .count('v', "verbose", "increase verbosity", &Options::verbosity)
+//         .list('f', "file", "files to load", &Options::files, "FILE")
+//         .compile();
+//
+//     Options opts;
+//     if (spec.parse(argc, argv, opts) == cli::ParseStatus::Help) { spec.print(std::cout); }
+//
+// Options are matched in registration order by the same rules as Parser,
+// and unused arguments are an error as with Parser::validate().
+// Subcommands are not supported.
+template <typename Out>
+class Spec {
+public:
+    // per-parse working state. keeping one per thread lets parse() reuse
+    // its allocations rather than building a new Context every call
+    class Scratch {
+    protected:
+        Context _ctx;
+        friend class Spec;
+
+    public:
+        // the error of the last parse() that returned ParseStatus::Error
+        const Error& error() const { return _ctx.error(); }
+        // and every error, with OnError::Collect
+        const Diagnostics& diagnostics() const { return _ctx.diagnostics(); }
+    };
+
+    class Builder;
+
+protected:
+    // members of any type are stored type erased and cast back by the
+    // converter that was instantiated alongside them
+    using Member = char Out::*;
+
+    enum class Kind : std::uint8_t {
+        Flag,
+        Count,
+        Arg,
+        List,
+        Positional,
+        AllPositionals
+    };
+
+    struct Option {
+        Kind kind;
+        char short_flag;
+        const char* long_flag; // name for positionals
+        ArgReq req;
+        bool invert;
+        Member member;
+        ErrorCode (*convert)(Out&, Member, StringView);
+        void (*add)(Out&, Member, std::size_t);
+    };
+
+    std::vector<Option> _opts;
+    char _help_short = 'h';
+    const char* _help_long = "help";
+    bool _response_files = false;
+    OnError _on_error = DEFAULT_ON_ERROR;
+    HelpMap _help;
+
+    template <typename T>
+    static Member erase(T Out::* m) { return reinterpret_cast<Member>(m); }
+    template <typename T>
+    static T& member(Out& out, Member m) { return out.*reinterpret_cast<T Out::*>(m); }
+
+    template <typename T>
+    static ErrorCode convert_into(Out& out, Member m, StringView arg) {
+        return TryFrom(arg, member<T>(out, m));
+    }
+    template <typename T>
+    static ErrorCode emplace_into(Out& out, Member m, StringView arg) {
+        return Emplace(member<T>(out, m), arg);
+    }
+    template <typename T>
+    static ErrorCode assign_into(Out& out, Member m, StringView arg) {
+        return Assign(member<T>(out, m), arg);
+    }
+    template <typename T>
+    static void add_into(Out& out, Member m, std::size_t n) {
+        member<T>(out, m) += n;
+    }
+
+public:
+    // response file tokens borrow from the Scratch that expanded them, so
+    // with response_files() this fails with ResponseFilesNeedScratch
+    ParseStatus parse(std::size_t argc, const char** argv, Out& out) const {
+        Scratch scratch;
+        if (_response_files) {
+            scratch._ctx.on_error(_on_error);
+            scratch._ctx.fail(Error(ErrorCode::ResponseFilesNeedScratch, Error::npos, 0, nullptr));
+            return ParseStatus::Error;
+        }
+        return parse(argc, argv, out, scratch);
+    }
+
+    ParseStatus parse(std::size_t argc, const char** argv, Out& out, Scratch& scratch) const {
+        auto& ctx = scratch._ctx;
+        // values from the files of the last parse are no longer valid
+        ctx.release_response_files();
+        ctx.reset(argc-1, argv+1, _help_short, _help_long);
+        ctx.on_error(_on_error);
+        if (_response_files) {
+            ctx.expand_response_files();
+        }
+        if (ctx.stopped()) {
+            return ParseStatus::Error;
+        }
+        if (ctx.wants_help()) {
+            return ParseStatus::Help;
+        }
+
+        for (auto& o : _opts) {
+            switch (o.kind) {
+            case Kind::Flag:
+                ctx.take_flag(o.short_flag, o.long_flag, member<bool>(out, o.member), o.invert);
+                break;
+
+            case Kind::Count:
+                o.add(out, o.member, ctx.take_count(o.short_flag, o.long_flag));
+                break;
+
+            case Kind::Arg: {
+                bool has_seen = ctx.take_arg(o.short_flag, o.long_flag, [&](StringView arg) {
+                    return o.convert(out, o.member, arg);
+                });
+                if (not has_seen and (o.req == ArgReq::Required)) {
+                    ctx.fail(Error(ErrorCode::MissingArgument, Error::npos, o.short_flag, o.long_flag));
+                }
+                break;
+            }
+
+            case Kind::List:
+                ctx.take_list(o.short_flag, o.long_flag, [&](StringView arg, std::size_t) {
+                    return o.convert(out, o.member, arg);
+                });
+                break;
+
+            case Kind::Positional: {
+                std::size_t at;
+                auto arg = ctx.take_positional(at);
+                if (arg.data() != nullptr) {
+                    auto err = o.convert(out, o.member, arg);
+                    if (err != ErrorCode::None) {
+                        ctx.fail(Error(err, at, 0, o.long_flag, arg.data()));
+                    }
+                } else if (o.req == ArgReq::Required) {
+                    ctx.fail(Error(ErrorCode::MissingArgument, Error::npos, 0, o.long_flag));
+                }
+                break;
+            }
+
+            case Kind::AllPositionals:
+                ctx.take_all_positionals([&](StringView arg) {
+                    return o.convert(out, o.member, arg);
+                });
+                break;
+            }
+
+            if (ctx.stopped()) {
+                return ParseStatus::Error;
+            }
+        }
+
+        ctx.validate();
+        return ctx.failed() ? ParseStatus::Error : ParseStatus::Ok;
+    }
+
+    void print(std::ostream& s) const {
+        _help.print(s);
+    }
+};
+
+template <typename Out>
+class Spec<Out>::Builder {
+protected:
+    Spec _spec;
+
+    Builder& add(Option o) {
+        _spec._opts.push_back(o);
+        return *this;
+    }
+
+public:
+    Builder() = default;
+
+    Spec compile() const {
+        return _spec;
+    }
+
+    //---------------------------------------------------------------------
+    // help setup
+    //---------------------------------------------------------------------
+
+    Builder& details(const char* name, const char* desc, const char* long_desc="") {
+        _spec._help.details(name, desc, long_desc);
+        return *this;
+    }
+
+    Builder& version(const char* v) {
+        _spec._help._app_version = v;
+        return *this;
+    }
+
+    Builder& indent_width(std::uint8_t w) {
+        _spec._help._indent_width = w;
+        return *this;
+    }
+
+    Builder& help(char s, const char* l) {
+        _spec._help_short = s;
+        _spec._help_long = l;
+        return *this;
+    }
+
+    // expand "@path" args, see ResponseFiles. the Scratch passed to parse()
+    // owns the mappings: StringView and const char* members bound to file
+    // tokens borrow from it, and are valid until its next parse() or its
+    // destruction. parse() without a Scratch fails
+    Builder& response_files() {
+        _spec._response_files = true;
+        return *this;
+    }
+
+    // how parse() reports errors. unless thrown, it returns
+    // ParseStatus::Error, and the Scratch holds the error(s)
+    Builder& on_error(OnError mode) {
+        _spec._on_error = mode;
+        return *this;
+    }
+
+    //---------------------------------------------------------------------
+    // options
+    //---------------------------------------------------------------------
+
+    Builder& flag(char s, const char* l, const char* desc, bool Out::* into, bool invert=false) {
+        _spec._help.add_arg(false, s, l, "", desc);
+        return add({Kind::Flag, s, l, ArgReq::Optional, invert, erase(into), nullptr, nullptr});
+    }
+    Builder& flag(char s, const char* desc, bool Out::* into, bool invert=false) {
+        return flag(s, "", desc, into, invert);
+    }
+    Builder& flag(const char* l, const char* desc, bool Out::* into, bool invert=false) {
+        return flag(0, l, desc, into, invert);
+    }
+
+    template <typename T>
+    Builder& count(char s, const char* l, const char* desc, T Out::* into) {
+        _spec._help.add_arg(false, s, l, "", desc);
+        return add({Kind::Count, s, l, ArgReq::Optional, false, erase(into), nullptr, &add_into<T>});
+    }
+    template <typename T>
+    Builder& count(char s, const char* desc, T Out::* into) {
+        return count(s, "", desc, into);
+    }
+    template <typename T>
+    Builder& count(const char* l, const char* desc, T Out::* into) {
+        return count(0, l, desc, into);
+    }
+
+    template <typename T>
+    Builder& arg(
+        char s, const char* l, const char* desc, T Out::* into,
+        const char* arg_desc="", ArgReq req = ArgReq::Optional
+    ) {
+        _spec._help.add_arg(false, s, l, arg_desc, desc, true);
+        return add({Kind::Arg, s, l, req, false, erase(into), &convert_into<T>, nullptr});
+    }
+    template <typename T>
+    Builder& arg(
+        char s, const char* desc, T Out::* into,
+        const char* arg_desc="", ArgReq req = ArgReq::Optional
+    ) {
+        return arg(s, "", desc, into, arg_desc, req);
+    }
+    template <typename T>
+    Builder& arg(
+        const char* l, const char* desc, T Out::* into,
+        const char* arg_desc="", ArgReq req = ArgReq::Optional
+    ) {
+        return arg(0, l, desc, into, arg_desc, req);
+    }
+
+    template <typename T>
+    Builder& list(char s, const char* l, const char* desc, T Out::* into, const char* arg_desc="") {
+        _spec._help.add_arg(false, s, l, arg_desc, desc, true);
+        return add({Kind::List, s, l, ArgReq::Optional, false, erase(into), &emplace_into<T>, nullptr});
+    }
+    template <typename T>
+    Builder& list(char s, const char* desc, T Out::* into) {
+        return list(s, nullptr, desc, into);
+    }
+    template <typename T>
+    Builder& list(const char* l, const char* desc, T Out::* into) {
+        return list(0, l, desc, into);
+    }
+
+    template <typename T>
+    Builder& positional(
+        const char* name, const char* desc, T Out::* into,
+        ArgReq req = ArgReq::Optional
+    ) {
+        _spec._help.add_positional(false, req, name, desc);
+        return add({Kind::Positional, 0, name, req, false, erase(into), &assign_into<T>, nullptr});
+    }
+
+    template <typename T>
+    Builder& all_positionals(const char* name, const char* desc, T Out::* into) {
+        _spec._help.add_variadic_positional(name, desc);
+        return add({Kind::AllPositionals, 0, name, ArgReq::Optional, false, erase(into), &emplace_into<T>, nullptr});
+    }
+};
+
+
+
+//-------------------------------------------------------------------------
+// compile-time schema
+//-------------------------------------------------------------------------
+
+struct SchemaOption {
+    char short_flag;
+    const char* long_flag;
+    bool takes_value;
+};
+
+constexpr std::size_t const_strlen(const char* s) {
+    std::size_t len = 0;
+    while ((s != nullptr) and (s[len] != '\0')) { len++; }
+    return len;
+}
+
+constexpr std::size_t next_pow2(std::size_t n) {
+    std::size_t p = 1;
+    while (p < n) { p <<= 1; }
+    return p;
+}
+
+// FNV-1a with the seed folded into the basis, then a 64 bit finalizer
+// so the low bits used for table indexing are well mixed
+constexpr std::uint64_t schema_hash(const char* s, std::size_t len, std::uint64_t seed) {
+    std::uint64_t h = 0xcbf29ce484222325ull ^ (seed * 0x9e3779b97f4a7c15ull);
+    for (std::size_t i = 0; i < len; i++) {
+        h ^= static_cast<unsigned char>(s[i]);
+        h *= 0x100000001b3ull;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+// Names fixed at compile time, placed with a hash-and-displace perfect
+// hash by the constexpr build(), so finding one hashes it and compares it
+// once. Empty names, and repeats of an earlier one, are left out.
+template <std::size_t N>
+class NameTable {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+protected:
+    static constexpr std::size_t TABLE_SIZE = next_pow2(2 * N);
+    static constexpr std::size_t NUM_BUCKETS = next_pow2(N);
+    static constexpr std::uint32_t MAX_DISPLACEMENT = 1 << 16;
+
+    const char* _names[N] = {};
+    std::size_t _lens[N] = {};
+
+    // tables store id+1 so that zero is empty
+    std::uint32_t _displacement[NUM_BUCKETS] = {};
+    std::uint16_t _slots[TABLE_SIZE] = {};
+
+    std::size_t _dup = npos;
+    bool _hashed = true;
+
+    constexpr bool equals(std::size_t id, const char* name, std::size_t len) const {
+        if (_lens[id] != len) { return false; }
+        for (std::size_t i = 0; i < len; i++) {
+            if (_names[id][i] != name[i]) { return false; }
+        }
+        return true;
+    }
+
+    constexpr std::size_t bucket(const char* name, std::size_t len) const {
+        return schema_hash(name, len, 0) & (NUM_BUCKETS - 1);
+    }
+
+    constexpr std::size_t slot(const char* name, std::size_t len, std::uint32_t displacement) const {
+        return schema_hash(name, len, displacement) & (TABLE_SIZE - 1);
+    }
+
+    // finds a displacement that puts every key of bucket `b` into a free slot
+    constexpr bool place(const std::size_t (&bucket_of)[N], std::size_t b) {
+        for (std::uint32_t d = 1; d < MAX_DISPLACEMENT; d++) {
+            std::size_t taken[N] = {};
+            std::size_t num_taken = 0;
+            bool fits = true;
+
+            for (std::size_t i = 0; fits and (i < N); i++) {
+                if (bucket_of[i] != b) { continue; }
+
+                auto pos = slot(_names[i], _lens[i], d);
+                fits = (_slots[pos] == 0);
+                for (std::size_t t = 0; fits and (t < num_taken); t++) {
+                    fits = (taken[t] != pos);
+                }
+                taken[num_taken++] = pos;
+            }
+
+            if (not fits) { continue; }
+
+            num_taken = 0;
+            for (std::size_t i = 0; i < N; i++) {
+                if (bucket_of[i] == b) {
+                    _slots[taken[num_taken++]] = i + 1;
+                }
+            }
+            _displacement[b] = d;
+            return true;
         }
+        return false;
+    }
+
+public:
+    // names `id`, noting the first id to repeat an earlier name
+    constexpr void set(std::size_t id, const char* name) {
+        _names[id] = name;
+        _lens[id] = const_strlen(name);
+        for (std::size_t j = 0; (j < id) and (_dup == npos); j++) {
+            if (_lens[id] and equals(j, name, _lens[id])) {
+                _dup = id;
+            }
+        }
+    }
+
+    // places the names, once all are set
+    constexpr void build() {
+        std::size_t bucket_of[N] = {};
+        std::size_t bucket_size[NUM_BUCKETS] = {};
+        std::size_t largest = 0;
+        for (std::size_t i = 0; i < N; i++) {
+            bucket_of[i] = npos;
+
+            bool repeated = (_lens[i] == 0);
+            for (std::size_t j = 0; not repeated and (j < i); j++) {
+                repeated = equals(j, _names[i], _lens[i]);
+            }
+            if (repeated) { continue; }
+
+            bucket_of[i] = bucket(_names[i], _lens[i]);
+            bucket_size[bucket_of[i]]++;
+            if (bucket_size[bucket_of[i]] > largest) {
+                largest = bucket_size[bucket_of[i]];
+            }
+        }
+
+        // the largest buckets are the hardest to fit, so place them first
+        for (std::size_t size = largest; size > 0; size--) {
+            for (std::size_t b = 0; b < NUM_BUCKETS; b++) {
+                if ((bucket_size[b] == size) and not place(bucket_of, b)) {
+                    _hashed = false;
+                    return;
+                }
+            }
+        }
+    }
+
+    // id of the first name repeating an earlier one, or npos
+    constexpr std::size_t duplicate() const { return _dup; }
+    // whether a perfect hash was found for the names
+    constexpr bool hashed() const { return _hashed; }
+
+    constexpr std::size_t find(const char* name, std::size_t len) const {
+        if (len == 0) { return npos; }
+
+        auto id = _slots[slot(name, len, _displacement[bucket(name, len)])];
+        if ((id == 0) or not equals(id - 1, name, len)) {
+            return npos;
+        }
+        return id - 1;
     }
 };
 
+template <std::size_t N> constexpr std::size_t NameTable<N>::npos;
+
+// An option set fixed at compile time.
+//
+// The 62 valid short flags index straight into a table, and long names
+// are placed in a NameTable, so resolving any argv token is O(1) in the
+// number of options and nothing is registered at runtime. Lookups are
+// exact: unlike Parser, abbreviated long names are not accepted.
+//
+// Declare one with CLIKIT_SCHEMA, which rejects duplicate short or long
+// flags with a static_assert:
+//
+//     constexpr cli::SchemaOption OPTS[] = {
+//         {'v', "verbose", false},
+//         {'o', "output", true},
+//     };
+//     CLIKIT_SCHEMA(SCHEMA, OPTS);
+//
+//     SCHEMA.scan(argc, argv, [&](std::size_t id, const char* value) { ... });
+template <std::size_t N>
+class Schema {
+public:
+    static_assert(N > 0, "schema must have at least one option");
+    static_assert(N < 0xFFFF, "schema option ids must fit in 16 bits");
+
+    // ids passed to scan() callbacks that are not an option
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    static constexpr std::size_t positional = npos - 1;
+    static constexpr std::size_t unknown = npos - 2;
+
+protected:
+    SchemaOption _opts[N] = {};
+    NameTable<N> _longs;
+
+    // stores id+1 so that zero is empty
+    std::uint16_t _shorts[NUM_SHORTS] = {};
+
+    char _dup_short = 0;
+
+public:
+    constexpr Schema(const SchemaOption (&opts)[N]) {
+        for (std::size_t i = 0; i < N; i++) {
+            _opts[i] = opts[i];
+            _longs.set(i, opts[i].long_flag);
+
+            auto s = opts[i].short_flag;
+            if (is_valid_short(s)) {
+                if (_shorts[short_slot(s)] and not _dup_short) {
+                    _dup_short = s;
+                }
+                _shorts[short_slot(s)] = i + 1;
+            }
+        }
+
+        _longs.build();
+    }
+
+    constexpr std::size_t size() const { return N; }
+    constexpr const SchemaOption& operator[](std::size_t id) const { return _opts[id]; }
+
+    // the first short flag given more than once, or 0
+    constexpr char duplicate_short() const { return _dup_short; }
+    // id of the first option repeating an earlier long flag, or npos
+    constexpr std::size_t duplicate_long() const { return _longs.duplicate(); }
+    // whether a perfect hash was found for the long flags
+    constexpr bool hashed() const { return _longs.hashed(); }
+
+    constexpr std::size_t find_short(char c) const {
+        if (not is_valid_short(c) or (_shorts[short_slot(c)] == 0)) { return npos; }
+        return _shorts[short_slot(c)] - 1;
+    }
+
+    constexpr std::size_t find_long(const char* name, std::size_t len) const {
+        return _longs.find(name, len);
+    }
+    constexpr std::size_t find_long(const char* name) const {
+        return find_long(name, const_strlen(name));
+    }
+
+    // Walks argv (skipping argv[0]) once, calling `fn(id, value)` per option
+    // occurrence in order. value is nullptr for options without a value.
+    // Tokens that are not options are given as `positional`, and options
+    // not in the schema as `unknown`, both with the whole token as value.
+    // Malformed options raise their Error.
+    template <typename Fn>
+    void scan(std::size_t argc, const char** argv, Fn&& fn) const {
+        auto err = try_scan(argc, argv, std::forward<Fn>(fn));
+        if (err) {
+            err.raise();
+        }
+    }
+
+    // as scan(), returning the error of a malformed option instead
+    template <typename Fn>
+    Error try_scan(std::size_t argc, const char** argv, Fn&& fn) const {
+        for (std::size_t i = 1; i < argc; i++) {
+            const char* arg = argv[i];
+            if ((arg[0] != '-') or (arg[1] == '\0') or ((arg[1] == '-') and (arg[2] == '\0'))) {
+                fn(positional, arg);
+                continue;
+            }
+
+            bool is_long = (arg[1] == '-');
+            const char* name = arg + (is_long ? 2 : 1);
+            const char* eq = strchr(name, '=');
+            std::size_t len = eq ? (eq - name) : strlen(name);
+
+            // resolve every flag in the token before acting on any of them
+            std::size_t id = is_long ? find_long(name, len) : find_short(name[0]);
+            bool known = (id != npos);
+            for (std::size_t c = 1; known and not is_long and (c < len); c++) {
+                known = (find_short(name[c]) != npos);
+            }
+            if (not known) {
+                fn(unknown, arg);
+                continue;
+            }
+
+            if ((not is_long and (len > 1)) or not _opts[id].takes_value) {
+                for (std::size_t c = 0; c < (is_long ? 1 : len); c++) {
+                    auto run_id = is_long ? id : find_short(name[c]);
+                    auto& opt = _opts[run_id];
+                    if (opt.takes_value) {
+                        return Error(ErrorCode::Run, i, name[c], nullptr);
+                    }
+                    if (eq != nullptr) {
+                        return Error(ErrorCode::UnexpectedValue, i, opt.short_flag, opt.long_flag, eq + 1);
+                    }
+                    fn(run_id, nullptr);
+                }
+                continue;
+            }
+
+            const char* value = eq ? (eq + 1) : nullptr;
+            if ((value == nullptr) and ((i + 1) < argc)) {
+                value = argv[++i];
+            }
+            if (value == nullptr) {
+                return Error(ErrorCode::MissingValue, i, _opts[id].short_flag, _opts[id].long_flag);
+            }
+            fn(id, value);
+        }
+        return Error();
+    }
+};
+
+template <std::size_t N> constexpr std::size_t Schema<N>::npos;
+template <std::size_t N> constexpr std::size_t Schema<N>::positional;
+template <std::size_t N> constexpr std::size_t Schema<N>::unknown;
+
+template <std::size_t N>
+constexpr Schema<N> make_schema(const SchemaOption (&opts)[N]) {
+    return Schema<N>(opts);
+}
+
+// declares a constexpr Schema `name` from a constexpr SchemaOption array,
+// failing the build on duplicate flags
+#define CLIKIT_SCHEMA(name, opts) \
+    constexpr auto name = ::cli::make_schema(opts); \
+    static_assert(name.duplicate_short() == 0, "duplicate short flag in cli schema"); \
+    static_assert(name.duplicate_long() == name.npos, "duplicate long flag in cli schema"); \
+    static_assert(name.hashed(), "no perfect hash found for cli schema long flags")
+
+
+//
+// subcommands
+//
+
+struct SubcommandDesc {
+    const char* name;
+    const char* desc;
+};
+
+// Subcommands fixed at compile time, placed in a NameTable so that
+// Parser::subcommand() dispatches on them with one hash and compare of
+// the arg, however many there are. Declare one with CLIKIT_SUBCOMMANDS,
+// which rejects duplicate names with a static_assert:
+//
+//     constexpr cli::SubcommandDesc SUBS[] = {
+//         {"build", "builds the project"},
+//         {"run", "runs the project"},
+//     };
+//     CLIKIT_SUBCOMMANDS(COMMANDS, SUBS);
+template <std::size_t N>
+class Subcommands {
+public:
+    static_assert(N > 0, "subcommand table must have at least one subcommand");
+    static_assert(N < 0xFFFF, "subcommand ids must fit in 16 bits");
+
+    static constexpr std::size_t npos = NameTable<N>::npos;
+
+protected:
+    SubcommandDesc _subs[N] = {};
+    NameTable<N> _names;
+
+public:
+    constexpr Subcommands(const SubcommandDesc (&subs)[N]) {
+        for (std::size_t i = 0; i < N; i++) {
+            _subs[i] = subs[i];
+            _names.set(i, subs[i].name);
+        }
+        _names.build();
+    }
+
+    constexpr std::size_t size() const { return N; }
+    constexpr const SubcommandDesc& operator[](std::size_t id) const { return _subs[id]; }
+    constexpr const SubcommandDesc* begin() const { return _subs; }
+    constexpr const SubcommandDesc* end() const { return _subs + N; }
+
+    // id of the first subcommand repeating an earlier name, or npos
+    constexpr std::size_t duplicate() const { return _names.duplicate(); }
+    // whether a perfect hash was found for the names
+    constexpr bool hashed() const { return _names.hashed(); }
+
+    constexpr std::size_t find(const char* name, std::size_t len) const {
+        return _names.find(name, len);
+    }
+    constexpr std::size_t find(const char* name) const {
+        return find(name, const_strlen(name));
+    }
+};
+
+template <std::size_t N> constexpr std::size_t Subcommands<N>::npos;
+
+template <std::size_t N>
+constexpr Subcommands<N> make_subcommands(const SubcommandDesc (&subs)[N]) {
+    return Subcommands<N>(subs);
+}
+
+// declares a constexpr Subcommands `name` from a constexpr SubcommandDesc
+// array, failing the build on duplicate names
+#define CLIKIT_SUBCOMMANDS(name, subs) \
+    constexpr auto name = ::cli::make_subcommands(subs); \
+    static_assert(name.duplicate() == name.npos, "duplicate name in cli subcommand table"); \
+    static_assert(name.hashed(), "no perfect hash found for cli subcommand names")
+
 } // end ns
 
 #endif
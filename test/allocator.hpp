@@ -0,0 +1,165 @@
+#ifndef __ALLOCATOR_TEST_HPP__
+#define __ALLOCATOR_TEST_HPP__
+
+#include <deque>
+#include <scoped_allocator>
+#include <set>
+#include <unordered_set>
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+// long enough to not fit in the small string buffer
+#define LONG_A "a-value-longer-than-sso"
+#define LONG_B "b-value-longer-than-sso"
+
+using ArenaStrings = std::vector<cli::ArenaString, cli::ArenaAllocator<cli::ArenaString>>;
+
+TEST(Allocator, List) {
+    const char* argv[] = {"hello", "--name", LONG_A, "--name=" LONG_B};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    cli::Arena arena;
+    ArenaStrings names{cli::ArenaAllocator<cli::ArenaString>(&arena)};
+
+    cli::Parser parse(argc, argv);
+    parse.list("name", "test", names);
+    parse.validate();
+
+    ASSERT_EQ(2, names.size());
+    EXPECT_STREQ(LONG_A, names[0].c_str());
+    EXPECT_STREQ(LONG_B, names[1].c_str());
+    for (auto& n : names) {
+        EXPECT_EQ(&arena, n.get_allocator().arena);
+    }
+}
+
+TEST(Allocator, Scoped) {
+    const char* argv[] = {"hello", LONG_A, LONG_B};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    using Alloc = std::scoped_allocator_adaptor<cli::ArenaAllocator<cli::ArenaString>>;
+    cli::Arena arena;
+    std::vector<cli::ArenaString, Alloc> args{Alloc(cli::ArenaAllocator<cli::ArenaString>(&arena))};
+
+    cli::Parser parse(argc, argv);
+    parse.all_positionals("ARGS", "test", args);
+
+    ASSERT_EQ(2, args.size());
+    EXPECT_STREQ(LONG_B, args[1].c_str());
+    for (auto& a : args) {
+        EXPECT_EQ(&arena, a.get_allocator().arena);
+    }
+}
+
+TEST(Allocator, Positional) {
+    const char* argv[] = {"hello", "run", LONG_A};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    cli::Arena arena;
+    cli::ArenaString cmd{cli::ArenaAllocator<char>(&arena)};
+    cli::ArenaString file{cli::ArenaAllocator<char>(&arena)};
+
+    cli::Parser parse(argc, argv);
+    parse.subcommand("run", "test", cmd);
+    parse.positional("FILE", "test", file);
+    parse.done();
+
+    EXPECT_STREQ("run", cmd.c_str());
+    EXPECT_STREQ(LONG_A, file.c_str());
+    EXPECT_EQ(&arena, cmd.get_allocator().arena);
+    EXPECT_EQ(&arena, file.get_allocator().arena);
+}
+
+TEST(Allocator, Containers) {
+    const char* argv[] = {"hello", "-n", "3", "-n", "1", "-n", "3", "-s", "x", "-s", "y"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::set<int> ordered;
+    std::unordered_set<std::string> names;
+    std::deque<double> values;
+
+    cli::Parser parse(argc, argv);
+    parse.list('n', "test", ordered);
+    parse.list('s', "test", names);
+    parse.reset(argc, argv);
+    parse.list('n', "test", values);
+
+    EXPECT_EQ((std::set<int>{1, 3}), ordered);
+    EXPECT_EQ((std::unordered_set<std::string>{"x", "y"}), names);
+    EXPECT_EQ((std::deque<double>{3, 1, 3}), values);
+}
+
+// a container with no allocator to construct values with
+template <typename T>
+struct AllocatorTestBag {
+    using value_type = T;
+    std::vector<T> values;
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) { values.emplace_back(std::forward<Args>(args)...); }
+};
+
+TEST(Allocator, WithoutAllocator) {
+    const char* argv[] = {"hello", "-n", "3", "--name", "x", "-n=1", "a", "b"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    AllocatorTestBag<int> counts;
+    AllocatorTestBag<std::string> names;
+    AllocatorTestBag<const char*> rest;
+
+    cli::Parser parse(argc, argv);
+    parse.list('n', "test", counts)
+        .list("name", "test", names)
+        .all_positionals("rest", "test", rest);
+    parse.validate();
+
+    EXPECT_EQ((std::vector<int>{3, 1}), counts.values);
+    EXPECT_EQ((std::vector<std::string>{"x"}), names.values);
+    ASSERT_EQ(2, rest.values.size());
+    EXPECT_STREQ("a", rest.values[0]);
+    EXPECT_STREQ("b", rest.values[1]);
+}
+
+TEST(Allocator, ReserveGrowsGeometrically) {
+    const char* argv[] = {"hello", "-n", "1", "-n", "2"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    // appending two at a time would reserve exactly every parse
+    std::vector<int> values;
+    cli::Parser parse(argc, argv);
+    std::size_t reallocations = 0;
+    for (std::size_t i = 0; i < 1000; i++) {
+        auto capacity = values.capacity();
+        parse.reset(argc, argv).list('n', "test", values);
+        reallocations += (values.capacity() != capacity);
+    }
+
+    EXPECT_EQ(2000, values.size());
+    EXPECT_LT(reallocations, 20);
+}
+
+#if __cplusplus >= 201703L
+TEST(Allocator, Pmr) {
+    const char* argv[] = {"hello", "--name", LONG_A, LONG_B};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::pmr::monotonic_buffer_resource pool;
+    std::pmr::vector<std::pmr::string> names(&pool);
+    std::pmr::vector<std::pmr::string> rest(&pool);
+
+    cli::Parser parse(argc, argv);
+    parse.list("name", "test", names);
+    parse.all_positionals("REST", "test", rest);
+
+    ASSERT_EQ(1, names.size());
+    ASSERT_EQ(1, rest.size());
+    EXPECT_EQ(&pool, names[0].get_allocator().resource());
+    EXPECT_EQ(&pool, rest[0].get_allocator().resource());
+}
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+// its own binary, as counting heap allocations replaces the global
+// operator new and delete
+
+#include <cstdlib>
+#include <new>
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+// heap allocations made by this thread while a HeapCount is alive, so
+// gtest's own allocations (and those of other threads) are left out
+static thread_local std::size_t heap_allocations = 0;
+static thread_local bool heap_counting = false;
+
+class HeapCount {
+public:
+    HeapCount() { heap_allocations = 0; heap_counting = true; }
+    ~HeapCount() { heap_counting = false; }
+
+    std::size_t allocations() const { return heap_allocations; }
+};
+
+void* operator new(std::size_t n) {
+    if (heap_counting) {
+        heap_allocations++;
+    }
+    if (auto p = std::malloc(n ? n : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+// kept out of line, where gcc would otherwise warn of free() on the
+// result of operator new
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    std::free(p);
+}
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+TEST(Arena, Allocate) {
+    cli::Arena arena(64);
+
+    // the first allocation reserves a block
+    void* a = nullptr;
+    {
+        HeapCount count;
+        a = arena.allocate(3, 1);
+        EXPECT_EQ(1, count.allocations());
+    }
+
+    auto b = arena.allocate(8, 8);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(b) % 8);
+
+    // larger than a block, and spilling into a new one
+    auto c = arena.allocate(1000, 16);
+    EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(c) % 16);
+    auto spilled = arena.capacity();
+    EXPECT_GE(spilled, 1064);
+
+    // rewinding merges the blocks into one big enough for the last round
+    arena.rewind();
+    EXPECT_EQ(spilled, arena.capacity());
+
+    HeapCount count;
+    arena.allocate(3, 1);
+    arena.allocate(8, 8);
+    arena.allocate(1000, 16);
+    EXPECT_EQ(0, count.allocations());
+}
+
+TEST(Arena, ReuseDoesNotAllocate) {
+    const char* first[] = {"hello", "-vvv", "--name", "x", "-i", "1", "--id=2", "pos", "a", "b"};
+    const char* second[] = {"hello", "--id", "7", "-v", "pos2", "--name=y"};
+    std::size_t first_argc = sizeof(first) / sizeof(first[0]);
+    std::size_t second_argc = sizeof(second) / sizeof(second[0]);
+
+    std::size_t verbose = 0;
+    const char* name = nullptr;
+    const char* pos = nullptr;
+    std::vector<std::size_t> ids;
+    std::vector<const char*> rest;
+    ids.reserve(16);
+    rest.reserve(16);
+
+    auto parse_all = [&](cli::Parser& parse) {
+        verbose = 0;
+        ids.clear();
+        rest.clear();
+        parse.count('v', "verbose", "test", verbose)
+             .arg('n', "name", "test", name, "NAME")
+             .list('i', "id", "test", ids)
+             .positional("pos", "test", pos)
+             .all_positionals("rest", "test", rest);
+        parse.validate();
+    };
+
+    // warm up on both
+    cli::Parser parse(first_argc, first);
+    parse_all(parse);
+    parse_all(parse.reset(second_argc, second));
+
+    std::size_t allocations = 0;
+    {
+        HeapCount count;
+        for (int i = 0; i < 10; i++) {
+            parse_all(parse.reset(first_argc, first));
+            parse_all(parse.reset(second_argc, second));
+        }
+        allocations = count.allocations();
+    }
+    EXPECT_EQ(0, allocations);
+
+    EXPECT_EQ(1, verbose);
+    EXPECT_STREQ("y", name);
+    EXPECT_STREQ("pos2", pos);
+    EXPECT_EQ(std::vector<std::size_t>{7}, ids);
+    EXPECT_TRUE(rest.empty());
+}
+
+TEST(Arena, ResetDetectsHelp) {
+    const char* plain[] = {"hello", "-v"};
+    const char* help[] = {"hello", "-v", "--help"};
+
+    cli::Arena arena;
+    bool verbose = false;
+
+    cli::Parser parse(arena, 2, plain);
+    parse.flag('v', "verbose", "test", verbose);
+    EXPECT_FALSE(parse.wants_help());
+    EXPECT_TRUE(verbose);
+
+    verbose = false;
+    parse.reset(3, help)
+         .flag('v', "verbose", "test", verbose);
+    EXPECT_TRUE(parse.wants_help());
+    EXPECT_FALSE(verbose);
+
+    parse.reset(2, plain)
+         .flag('v', "verbose", "test", verbose);
+    EXPECT_FALSE(parse.wants_help());
+    EXPECT_TRUE(verbose);
+}
@@ -52,6 +52,21 @@ TEST(Arg, LongWithEq) {
     EXPECT_EQ(count, 123);
 }
 
+TEST(Arg, ValueLooksLikeFlag) {
+    const char* argv[] = {"hello", "-n", "-n", "-v"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::string name;
+    bool verbose = false;
+
+    cli::Parser parse(argc, argv);
+    parse.arg('n', "test", name)
+         .flag('v', "test", verbose);
+
+    EXPECT_EQ("-n", name);
+    EXPECT_TRUE(verbose);
+}
+
 
 //-------------------------------------------------------------------------
 // error testing
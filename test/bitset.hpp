@@ -0,0 +1,85 @@
+#ifndef __BITSET_TEST_HPP__
+#define __BITSET_TEST_HPP__
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+static std::vector<std::size_t> bitset_unset(const cli::BitSet& set) {
+    std::vector<std::size_t> out;
+    for (auto i = set.unset_begin(); i != set.unset_end(); ++i) {
+        out.push_back(*i);
+    }
+    return out;
+}
+
+TEST(BitSet, SmallDoesNotAllocate) {
+    // anything the set allocates comes from the arena
+    cli::Arena arena;
+    cli::BitSet set(cli::BitSet::INLINE_WORDS * cli::BitSet::BITS_PER_SIZET, &arena);
+    set.set(0);
+    set.set(127);
+    EXPECT_EQ(0, arena.capacity());
+    EXPECT_EQ(2, set.size());
+
+    cli::BitSet spilled(cli::BitSet::INLINE_WORDS * cli::BitSet::BITS_PER_SIZET + 1, &arena);
+    EXPECT_NE(0, arena.capacity());
+}
+
+TEST(BitSet, SmallAndSpilled) {
+    for (std::size_t n : {1, 3, 64, 65, 128, 129, 200, 1000}) {
+        cli::BitSet set(n);
+        std::vector<std::size_t> expected;
+        for (std::size_t i = 0; i < n; i++) {
+            if ((i % 3 == 0) or (i == n - 1)) {
+                set.set(i);
+            } else {
+                expected.push_back(i);
+            }
+        }
+        EXPECT_EQ(expected, bitset_unset(set)) << n;
+        EXPECT_EQ(expected.size(), set.remaining()) << n;
+
+        // moves keep the bits, wherever they are stored
+        cli::BitSet moved(std::move(set));
+        EXPECT_EQ(expected, bitset_unset(moved)) << n;
+        cli::BitSet assigned;
+        assigned = std::move(moved);
+        EXPECT_EQ(expected, bitset_unset(assigned)) << n;
+
+        // and resetting moves between them
+        assigned.reset(n / 2);
+        EXPECT_EQ(0, assigned.size()) << n;
+        EXPECT_EQ(n / 2, assigned.remaining()) << n;
+    }
+}
+
+TEST(BitSet, MostlySetSkipsFullWords) {
+    // spans several summary words, with a partial last word
+    const std::size_t n = 64 * 64 * 3 + 5;
+    cli::BitSet set(n);
+    for (std::size_t i = 0; i < n; i++) { set.set(i); }
+    EXPECT_EQ(n, set.size());
+    EXPECT_EQ(0, set.remaining());
+    EXPECT_TRUE(bitset_unset(set).empty());
+
+    std::vector<std::size_t> open = {0, 63, 64, 4095, 4096, 64 * 64 * 2 + 1, n - 1};
+    for (auto i : open) { set.unset(i); }
+    set.unset(0); // twice changes nothing
+    EXPECT_EQ(open, bitset_unset(set));
+    EXPECT_EQ(open.size(), set.remaining());
+
+    // refilling a word marks it full again
+    set.set(4095);
+    set.set(4095);
+    open.erase(open.begin() + 3);
+    EXPECT_EQ(open, bitset_unset(set));
+    EXPECT_EQ(n - open.size(), set.size());
+
+    cli::BitSet moved(std::move(set));
+    EXPECT_EQ(open, bitset_unset(moved));
+    EXPECT_EQ(open.size(), moved.remaining());
+}
+
+#endif
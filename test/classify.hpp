@@ -0,0 +1,123 @@
+#ifndef __CLASSIFY_TEST_HPP__
+#define __CLASSIFY_TEST_HPP__
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+static void expect_same_desc(const cli::ParseDesc& expected, const cli::ParseDesc& got, const char* arg) {
+    EXPECT_EQ(expected.is_short, got.is_short) << arg;
+    EXPECT_EQ(expected.is_long, got.is_long) << arg;
+    EXPECT_EQ(expected.len, got.len) << arg;
+    EXPECT_EQ(expected.eq_offset, got.eq_offset) << arg;
+    EXPECT_EQ(expected.runs_remaining, got.runs_remaining) << arg;
+    EXPECT_EQ(expected.shorts, got.shorts) << arg;
+    EXPECT_EQ(expected.repeats, got.repeats) << arg;
+}
+
+TEST(Classify, MatchesScalarAtEveryAlignment) {
+    const char* samples[] = {
+        "", "-", "--", "-v", "-vvx", "--help", "--file=a=b", "-n=1",
+        "positional=value", "a-very-long-positional-argument-spanning-blocks",
+        "--a-very-long-flag-name-spanning-several-blocks=and-a-value",
+    };
+
+    // copy each sample to every offset within a block so the
+    // vectorized scan sees every alignment of start and terminator
+    char buf[256] __attribute__((aligned(16)));
+    for (auto sample : samples) {
+        for (std::size_t offset = 0; offset < 16; offset++) {
+            strcpy(buf + offset, sample);
+            const char* argv[] = {buf + offset};
+
+            std::vector<cli::ParseDesc> desc;
+            cli::classify_args(1, argv, 'h', "help", desc);
+
+            ASSERT_EQ(1, desc.size());
+            expect_same_desc(cli::ParseDesc(argv[0]), desc[0], sample);
+        }
+    }
+}
+
+TEST(Classify, Threaded) {
+    std::size_t argc = cli::CLASSIFY_ARGS_PER_THREAD * 4 + 3;
+    std::vector<std::string> storage;
+    storage.reserve(argc);
+    for (std::size_t i = 0; i < argc; i++) {
+        switch (i % 4) {
+        case 0: storage.push_back("file-" + std::to_string(i)); break;
+        case 1: storage.push_back("-v"); break;
+        case 2: storage.push_back("--key=" + std::to_string(i)); break;
+        case 3: storage.push_back("--flag"); break;
+        }
+    }
+    storage[argc - 2] = "--help";
+    std::vector<const char*> argv;
+    for (auto& s : storage) { argv.push_back(s.c_str()); }
+
+    std::vector<cli::ParseDesc> desc;
+    cli::classify_args(argc, argv.data(), 'h', "help", desc, 4);
+
+    ASSERT_EQ(argc, desc.size());
+    std::size_t help = 0;
+    for (std::size_t i = 0; i < argc; i++) {
+        expect_same_desc(cli::ParseDesc(argv[i]), desc[i], argv[i]);
+        help += desc[i].is_help ? 1 : 0;
+    }
+    EXPECT_EQ(1, help);
+    EXPECT_TRUE(desc[argc - 2].is_help);
+}
+
+TEST(Classify, ArgTableMatchesVector) {
+    const char* argv[] = {"tool", "-vvx", "--file=a=b", "-n=1", "--help", "-h", "pos"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::vector<cli::ParseDesc> desc;
+    cli::classify_args(argc, argv, 'h', "help", desc);
+    cli::ArgTable table;
+    cli::classify_args(argc, argv, 'h', "help", table);
+
+    ASSERT_EQ(argc, table.size());
+    for (std::size_t i = 0; i < argc; i++) {
+        expect_same_desc(desc[i], table.get(i), argv[i]);
+        EXPECT_EQ(desc[i].is_help, table.is_help(i)) << argv[i];
+        EXPECT_EQ(desc[i].is_positional(), table[i].is_positional()) << argv[i];
+        EXPECT_EQ(desc[i].name_len(), table[i].name_len()) << argv[i];
+        EXPECT_EQ(desc[i].matches(argv[i], 'v'), table[i].matches(argv[i], 'v')) << argv[i];
+        EXPECT_EQ(desc[i].matches(argv[i], "file"), table[i].matches(argv[i], "file")) << argv[i];
+    }
+}
+
+TEST(Classify, ArgsPastSixtyFourKiB) {
+    // e.g. inline JSON or certificates, whose lengths overflowed 16 bits
+    std::string blob = "--blob=" + std::string(3 << 20, 'j');
+    std::string cert = std::string(70000, 'c');
+    std::string run = "-" + std::string(70000, 'v');
+    const char* argv[] = {"tool", blob.c_str(), run.c_str(), cert.c_str()};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::vector<cli::ParseDesc> desc;
+    cli::classify_args(argc, argv, 'h', "help", desc);
+    EXPECT_EQ(blob.size(), desc[1].len);
+    EXPECT_EQ(6, desc[1].eq_offset);
+    EXPECT_EQ(70000, desc[2].runs_remaining);
+    EXPECT_EQ(cert.size(), desc[3].len);
+
+    const char* value = nullptr;
+    std::size_t verbosity = 0;
+    const char* file = nullptr;
+    cli::Parser parse(argc, argv);
+    parse.arg("blob", "test", value, "JSON")
+        .count('v', "verbose", "test", verbosity)
+        .positional("file", "test", file)
+        .validate();
+    EXPECT_FALSE(parse.failed());
+
+    EXPECT_EQ(blob.c_str() + 7, value);
+    EXPECT_EQ(70000, verbosity);
+    EXPECT_EQ(cert.c_str(), file);
+}
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef __COMPLETE_TEST_HPP__
+#define __COMPLETE_TEST_HPP__
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+// completes `words` at `index` through a chain with a nested subcommand
+static std::string complete_test_chain(std::size_t index, std::vector<const char*> words) {
+    auto idx = std::to_string(index);
+    std::vector<const char*> argv = {"tool", cli::COMPLETE_FLAG, idx.c_str()};
+    argv.insert(argv.end(), words.begin(), words.end());
+
+    int verbose = 0;
+    std::size_t jobs = 0;
+    bool release = false;
+    bool build = false;
+    bool docs = false;
+    bool run = false;
+    const char* target = nullptr;
+
+    cli::Parser parse(argv.size(), argv.data());
+    parse.dynamic_help()
+        .count('v', "verbose", "test", verbose)
+        .arg('j', "jobs", "test", jobs, "N")
+        .subcommand("build", "test", build)
+            .flag('r', "release", "test", release)
+            .subcommand("docs", "test", docs)
+            .done()
+            .positional("target", "test", target)
+        .done()
+        .subcommand("run", "test", run)
+        .done();
+
+    EXPECT_TRUE(parse.wants_help());
+    EXPECT_FALSE(parse.failed());
+
+    testing::internal::CaptureStdout();
+    parse.print();
+    return testing::internal::GetCapturedStdout();
+}
+
+TEST(Complete, ParsesRequest) {
+    const char* argv[] = {"tool", "--__complete", "2", "tool", "build"};
+    cli::CompletionRequest req;
+    ASSERT_TRUE(req.parse(5, argv));
+    EXPECT_EQ(2u, req.count);
+    EXPECT_EQ(2u, req.index);
+    EXPECT_STREQ("", req.current());
+    EXPECT_EQ(nullptr, req.shell);
+
+    const char* script[] = {"tool", "--__completion", "zsh"};
+    ASSERT_TRUE(req.parse(3, script));
+    EXPECT_STREQ("zsh", req.shell);
+
+    const char* plain[] = {"tool", "build"};
+    EXPECT_FALSE(req.parse(2, plain));
+}
+
+TEST(Complete, Subcommands) {
+    EXPECT_EQ("build\nrun\n", complete_test_chain(1, {"tool"}));
+    EXPECT_EQ("run\n", complete_test_chain(1, {"tool", "r"}));
+    EXPECT_EQ("docs\n", complete_test_chain(2, {"tool", "build", ""}));
+}
+
+TEST(Complete, Flags) {
+    EXPECT_EQ(
+        "-v\n--verbose\n-j\n--jobs\n-h\n--help\n",
+        complete_test_chain(1, {"tool", "-"})
+    );
+    EXPECT_EQ("--release\n", complete_test_chain(2, {"tool", "build", "--re"}));
+}
+
+TEST(Complete, SkipsOptionsAndValues) {
+    // "4" is the value of -j, not a positional
+    EXPECT_EQ("docs\n", complete_test_chain(5, {"tool", "-v", "-j", "4", "build"}));
+    EXPECT_EQ("build\nrun\n", complete_test_chain(2, {"tool", "--jobs=4"}));
+
+    // values and positionals are left to the shell
+    EXPECT_EQ("", complete_test_chain(2, {"tool", "-j"}));
+    EXPECT_EQ("", complete_test_chain(3, {"tool", "build", "x"}));
+}
+
+static const char COMPLETE_TEST_TOP[] = "cremote\nf-v\nv--name\n";
+static const char COMPLETE_TEST_REMOTE[] = "cadd\ncremove\nf-v\nv--name\n";
+static const cli::EmbeddedHelp COMPLETE_TEST_TABLE[] = {
+    {"", "", 0, COMPLETE_TEST_TOP, sizeof(COMPLETE_TEST_TOP) - 1},
+    {" remote", "", 0, COMPLETE_TEST_REMOTE, sizeof(COMPLETE_TEST_REMOTE) - 1},
+};
+
+TEST(Complete, FromEmbeddedSpec) {
+    cli::embed_help(COMPLETE_TEST_TABLE, 2);
+
+    const char* argv[] = {"tool", "--__complete", "4", "tool", "--name", "x", "remote", "a"};
+    cli::CompletionRequest req;
+    ASSERT_TRUE(req.parse(8, argv));
+    std::string out;
+    ASSERT_TRUE(cli::complete(req, out));
+    EXPECT_EQ("add\n", out);
+
+    testing::internal::CaptureStdout();
+    EXPECT_TRUE(cli::complete(8, argv));
+    EXPECT_EQ("add\n", testing::internal::GetCapturedStdout());
+
+    cli::embed_help(nullptr, 0);
+    out.clear();
+    EXPECT_FALSE(cli::complete(req, out));
+}
+
+TEST(Complete, Scripts) {
+    auto bash = cli::completion_script("bash", "/usr/bin/my-tool");
+    EXPECT_NE(std::string::npos, bash.find("complete -o default -F _clikit_complete_my_tool my-tool\n"));
+    EXPECT_NE(std::string::npos, cli::completion_script("zsh", "my-tool").find("#compdef my-tool\n"));
+    EXPECT_NE(std::string::npos, cli::completion_script("fish", "my-tool").find("complete -c my-tool "));
+    EXPECT_EQ("", cli::completion_script("tcsh", "my-tool"));
+
+    // the parser answers script requests too
+    const char* argv[] = {"my-tool", "--__completion", "bash"};
+    bool verbose = false;
+    cli::Parser parse(3, argv);
+    parse.flag('v', "verbose", "test", verbose);
+    ASSERT_TRUE(parse.wants_help());
+
+    testing::internal::CaptureStdout();
+    parse.print();
+    EXPECT_EQ(bash, testing::internal::GetCapturedStdout());
+}
+
+#endif
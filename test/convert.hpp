@@ -0,0 +1,273 @@
+#ifndef __CONVERT_TEST_HPP__
+#define __CONVERT_TEST_HPP__
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+template <typename T>
+static cli::ConvertError parse_int(const char* s, T& out) {
+    return cli::parse_integer(s, out);
+}
+
+TEST(Convert, Integers) {
+    std::uint64_t u = 0;
+    std::int64_t i = 0;
+
+    EXPECT_EQ(cli::ConvertError::None, parse_int("18446744073709551615", u));
+    EXPECT_EQ(UINT64_MAX, u);
+    EXPECT_EQ(cli::ConvertError::None, parse_int("-9223372036854775808", i));
+    EXPECT_EQ(INT64_MIN, i);
+    EXPECT_EQ(cli::ConvertError::None, parse_int("+42", i));
+    EXPECT_EQ(42, i);
+    EXPECT_EQ(cli::ConvertError::None, parse_int("098", u));
+    EXPECT_EQ(98, u);
+}
+
+TEST(Convert, Prefixes) {
+    std::uint32_t u = 0;
+    std::int32_t i = 0;
+
+    EXPECT_EQ(cli::ConvertError::None, parse_int("0xff", u));
+    EXPECT_EQ(255, u);
+    EXPECT_EQ(cli::ConvertError::None, parse_int("0X1E", u));
+    EXPECT_EQ(30, u);
+    EXPECT_EQ(cli::ConvertError::None, parse_int("0o17", u));
+    EXPECT_EQ(15, u);
+    EXPECT_EQ(cli::ConvertError::None, parse_int("-0b101", i));
+    EXPECT_EQ(-5, i);
+}
+
+TEST(Convert, Suffixes) {
+    std::uint64_t u = 0;
+
+    EXPECT_EQ(cli::ConvertError::None, parse_int("4K", u));
+    EXPECT_EQ(4096, u);
+    EXPECT_EQ(cli::ConvertError::None, parse_int("4k", u));
+    EXPECT_EQ(4096, u);
+    EXPECT_EQ(cli::ConvertError::None, parse_int("16MiB", u));
+    EXPECT_EQ(16ull << 20, u);
+    EXPECT_EQ(cli::ConvertError::None, parse_int("1G", u));
+    EXPECT_EQ(1ull << 30, u);
+    EXPECT_EQ(cli::ConvertError::None, parse_int("2Ki", u));
+    EXPECT_EQ(2048, u);
+    EXPECT_EQ(cli::ConvertError::None, parse_int("3MB", u));
+    EXPECT_EQ(3000000, u);
+    EXPECT_EQ(cli::ConvertError::None, parse_int("0x10K", u));
+    EXPECT_EQ(16384, u);
+}
+
+TEST(Convert, FromUsesFastPath) {
+    const char* argv[] = {"hello", "--block-size", "64K", "-n", "0x10"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::size_t block_size = 0;
+    std::uint8_t n = 0;
+
+    cli::Parser parse(argc, argv);
+    parse.arg('b', "block-size", "test", block_size)
+         .arg('n', "test", n);
+
+    EXPECT_EQ(65536, block_size);
+    EXPECT_EQ(16, n);
+}
+
+// bitwise equality, so -0.0 and NaN payloads count
+template <typename T>
+static ::testing::AssertionResult same_bits(const char* text, T expect, T actual) {
+    if (memcmp(&expect, &actual, sizeof(T)) == 0) {
+        return ::testing::AssertionSuccess();
+    }
+    return ::testing::AssertionFailure()
+        << "'" << text << "': expected " << expect << " got " << actual;
+}
+
+static float strto(const char* text, float) { return strtof(text, nullptr); }
+static double strto(const char* text, double) { return strtod(text, nullptr); }
+
+// parses `text` like strtod, treating rounding to infinity as out of range
+template <typename T>
+static ::testing::AssertionResult round_trips(const char* text, T value) {
+    auto expect = strto(text, value);
+    auto err = cli::parse_float(text, value);
+    if (err == cli::ConvertError::None) {
+        return same_bits(text, expect, value);
+    }
+    if ((err == cli::ConvertError::Overflow) and std::isinf(expect)) {
+        return ::testing::AssertionSuccess();
+    }
+    return ::testing::AssertionFailure() << "'" << text << "' did not parse";
+}
+
+static ::testing::AssertionResult round_trips(const char* text) {
+    auto result = round_trips(text, 0.0);
+    return result ? round_trips(text, 0.0f) : result;
+}
+
+static std::uint64_t xorshift(std::uint64_t& x) {
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    return x;
+}
+
+TEST(Convert, Floats) {
+    const char* cases[] = {
+        "0", "-0", "1", "+1", "0.1", ".5", "5.", "3.14159", "1e10", "1E-10",
+        "123456789012345678", "1.7976931348623157e308", "2.2250738585072014e-308",
+        "2.2250738585072011e-308", "4.9406564584124654e-324", "2.4703282292062328e-324",
+        "2.4703282292062327e-324", "1e-400", "3.4028234663852886e38",
+        "1.1754943508222875e-38", "1.401298464324817e-45", "7.006492321624085e-46",
+        "9007199254740993", "9007199254740992.5", "9007199254740993.0000000000000000001",
+        "0.000000000000000000000000000000000000000000001234567890123456789012345",
+        "12345678901234567890123456789e-29", "1e23", "8.98846567431158e307",
+        "179769313486231580793728971405303415079934132710037826936173778980444968292764750946649017977587207096330286416692887910946555547851940402630657488671505820681908902000708383676273854845817711531764475730270069855571366959622842914819860834936475292719074168444365510704342711559699508093042880177904174497791.9999999999999999999999999999999999999999999999999999999999999999999999",
+        "1e", "1.5e+", "2e-3x",
+    };
+    for (auto text : cases) {
+        const char* end = nullptr;
+        double d = 0;
+        ASSERT_EQ(cli::ConvertError::None, cli::parse_float(text, d, &end)) << text;
+
+        char* expect_end = nullptr;
+        EXPECT_TRUE(same_bits(text, strtod(text, &expect_end), d));
+        EXPECT_EQ(expect_end, end) << text;
+    }
+
+    double d = 0;
+    EXPECT_EQ(cli::ConvertError::None, cli::parse_float("-inf", d));
+    EXPECT_TRUE(std::isinf(d) and (d < 0));
+    EXPECT_EQ(cli::ConvertError::None, cli::parse_float("Infinity", d));
+    EXPECT_TRUE(std::isinf(d) and (d > 0));
+    EXPECT_EQ(cli::ConvertError::None, cli::parse_float("NaN", d));
+    EXPECT_TRUE(std::isnan(d));
+    EXPECT_EQ(cli::ConvertError::None, cli::parse_float("0x1.8p1", d));
+    EXPECT_EQ(3.0, d);
+
+    long double ld = 0;
+    EXPECT_EQ(cli::ConvertError::None, cli::parse_float("0.1", ld));
+    EXPECT_EQ(0.1L, ld);
+}
+
+TEST(Convert, FloatRoundTrip) {
+    std::uint64_t x = 88172645463325252ull;
+    char text[64];
+
+    // every finite double printed at full and reduced precision
+    for (int i = 0; i < 50000; i++) {
+        std::uint64_t bits = xorshift(x);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (not std::isfinite(value)) { continue; }
+
+        snprintf(text, sizeof(text), "%.17g", value);
+        ASSERT_TRUE(round_trips(text));
+        snprintf(text, sizeof(text), "%.*g", static_cast<int>(1 + bits % 16), value);
+        ASSERT_TRUE(round_trips(text));
+
+        float f;
+        std::uint32_t fbits = static_cast<std::uint32_t>(bits);
+        memcpy(&f, &fbits, sizeof(f));
+        if (std::isfinite(f)) {
+            snprintf(text, sizeof(text), "%.9g", f);
+            ASSERT_TRUE(round_trips(text));
+        }
+    }
+
+    // long, random digit strings and exponents, to hit the truncated path
+    for (int i = 0; i < 50000; i++) {
+        std::string s;
+        auto digits = 1 + xorshift(x) % 30;
+        for (std::uint64_t n = 0; n < digits; n++) {
+            s.push_back('0' + xorshift(x) % 10);
+        }
+        s.insert(xorshift(x) % (s.size() + 1), ".");
+        s += "e" + std::to_string(static_cast<int>(xorshift(x) % 700) - 350);
+        ASSERT_TRUE(round_trips(s.c_str()));
+    }
+}
+
+TEST(Convert, FromFloat) {
+    const char* argv[] = {"hello", "-w", "0.25", "-w", "-1e-3", "--scale", "1.5"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::vector<double> weights;
+    float scale = 0;
+
+    cli::Parser parse(argc, argv);
+    parse.list('w', "weights", weights)
+         .arg('s', "scale", "test", scale);
+
+    ASSERT_EQ(2, weights.size());
+    EXPECT_EQ(0.25, weights[0]);
+    EXPECT_EQ(-1e-3, weights[1]);
+    EXPECT_EQ(1.5f, scale);
+}
+
+
+//-------------------------------------------------------------------------
+// error testing
+//-------------------------------------------------------------------------
+
+TEST(Convert, IntegerErrors) {
+    std::uint8_t u8 = 7;
+    std::int8_t i8 = 7;
+    std::uint64_t u = 0;
+
+    EXPECT_EQ(cli::ConvertError::Empty, parse_int("", u8));
+    EXPECT_EQ(cli::ConvertError::Invalid, parse_int("abc", u8));
+    EXPECT_EQ(cli::ConvertError::Invalid, parse_int("12abc", u8));
+    EXPECT_EQ(cli::ConvertError::Invalid, parse_int("0x", u8));
+    EXPECT_EQ(cli::ConvertError::Invalid, parse_int("4KiBs", u));
+    EXPECT_EQ(cli::ConvertError::Overflow, parse_int("256", u8));
+    EXPECT_EQ(cli::ConvertError::Overflow, parse_int("-1", u8));
+    EXPECT_EQ(cli::ConvertError::Overflow, parse_int("128", i8));
+    EXPECT_EQ(cli::ConvertError::Overflow, parse_int("-129", i8));
+    EXPECT_EQ(cli::ConvertError::Overflow, parse_int("1K", u8));
+    EXPECT_EQ(cli::ConvertError::Overflow, parse_int("16E", u));
+    EXPECT_EQ(cli::ConvertError::Overflow, parse_int("18446744073709551616", u));
+
+    // failures leave the output untouched
+    EXPECT_EQ(7, u8);
+    EXPECT_EQ(7, i8);
+
+    EXPECT_THROW(cli::From<std::uint16_t>("65536"), cli::ParseError);
+    EXPECT_THROW(cli::From<std::int32_t>("ten"), cli::ParseError);
+}
+
+TEST(Convert, FloatErrors) {
+    double d = 7;
+    float f = 7;
+
+    EXPECT_EQ(cli::ConvertError::Empty, cli::parse_float("", d));
+    EXPECT_EQ(cli::ConvertError::Invalid, cli::parse_float(".", d));
+    EXPECT_EQ(cli::ConvertError::Invalid, cli::parse_float("-", d));
+    EXPECT_EQ(cli::ConvertError::Invalid, cli::parse_float(" 1", d));
+    EXPECT_EQ(cli::ConvertError::Invalid, cli::parse_float("1.5x", d));
+    EXPECT_EQ(cli::ConvertError::Invalid, cli::parse_float("1e", d));
+    EXPECT_EQ(cli::ConvertError::Invalid, cli::parse_float("infinit", d));
+    EXPECT_EQ(cli::ConvertError::Invalid, cli::parse_float("0x1p3junk", d));
+    EXPECT_EQ(cli::ConvertError::Overflow, cli::parse_float("1e309", d));
+    EXPECT_EQ(cli::ConvertError::Overflow, cli::parse_float("-1e39", f));
+    EXPECT_EQ(cli::ConvertError::Overflow, cli::parse_float("0x1p1024", d));
+
+    // failures leave the output untouched
+    EXPECT_EQ(7, d);
+    EXPECT_EQ(7, f);
+
+    // without strict mode parsing stops at the first character past the number
+    const char* text = "2.5e3ms";
+    const char* end = nullptr;
+    EXPECT_EQ(cli::ConvertError::None, cli::parse_float(text, d, &end));
+    EXPECT_EQ(2500, d);
+    EXPECT_STREQ("ms", end);
+
+    EXPECT_THROW(cli::From<double>("1.0.0"), cli::ParseError);
+    EXPECT_THROW(cli::From<float>("1e40"), cli::ParseError);
+    EXPECT_THROW(cli::From<long double>("x"), cli::ParseError);
+}
+
+#endif
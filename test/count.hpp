@@ -58,6 +58,32 @@ TEST(Count, MultipleRuns) {
     EXPECT_EQ(count, 6);
 }
 
+TEST(Count, LongRun) {
+    std::string run = "-";
+    for (std::size_t i = 0; i < 5000; i++) {
+        run += (i % 3) ? 'v' : 'x';
+    }
+    const char* argv[] = {"hello", run.c_str(), "-q"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::size_t count_v = 0;
+    std::size_t count_x = 0;
+    std::size_t count_q = 0;
+    std::size_t count_z = 0;
+
+    cli::Parser parse(argc, argv);
+    parse.count('v', "test", count_v)
+        .count('z', "test", count_z)
+        .count('x', "test", count_x)
+        .count('q', "test", count_q);
+
+    EXPECT_EQ(3333, count_v);
+    EXPECT_EQ(1667, count_x);
+    EXPECT_EQ(1, count_q);
+    EXPECT_EQ(0, count_z);
+    EXPECT_EQ(0, parse.gather_remaining().size());
+}
+
 
 //-------------------------------------------------------------------------
 // error tests
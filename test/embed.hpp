@@ -0,0 +1,63 @@
+#ifndef __EMBED_TEST_HPP__
+#define __EMBED_TEST_HPP__
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+static const cli::EmbeddedHelp EMBED_TEST_TABLE[] = {
+    {"", "top level\n", 10},
+    {" remote", "remote help\n", 12},
+};
+
+// prints the help for `argv` through a chain with one nested subcommand
+static std::string embed_test_print(std::size_t argc, const char** argv, bool dynamic) {
+    bool verbose = false;
+    bool remote = false;
+    bool add = false;
+
+    cli::Parser parse(argc, argv);
+    if (dynamic) {
+        parse.dynamic_help();
+    }
+    parse.details("tool", "test")
+        .flag('v', "verbose", "test", verbose)
+        .subcommand("remote", "test", remote)
+            .subcommand("add", "test", add)
+            .done()
+        .done();
+
+    testing::internal::CaptureStdout();
+    parse.print();
+    return testing::internal::GetCapturedStdout();
+}
+
+TEST(Embed, PrintsBlockForPath) {
+    cli::embed_help(EMBED_TEST_TABLE, 2);
+
+    const char* top[] = {"tool", "--help"};
+    EXPECT_EQ("top level\n", embed_test_print(2, top, false));
+
+    const char* remote[] = {"tool", "remote", "-h"};
+    EXPECT_EQ("remote help\n", embed_test_print(3, remote, false));
+
+    EXPECT_EQ(nullptr, cli::find_embedded_help(" remote add"));
+    ASSERT_NE(nullptr, cli::find_embedded_help(" remote"));
+
+    cli::embed_help(nullptr, 0);
+}
+
+TEST(Embed, FallsBackToDynamic) {
+    cli::embed_help(EMBED_TEST_TABLE, 2);
+
+    // runtime options opt out
+    const char* top[] = {"tool", "--help"};
+    auto dynamic = embed_test_print(2, top, true);
+    EXPECT_NE(std::string::npos, dynamic.find("-v/--verbose"));
+
+    cli::embed_help(nullptr, 0);
+    EXPECT_EQ(dynamic, embed_test_print(2, top, false));
+}
+
+#endif
@@ -0,0 +1,421 @@
+#ifndef __ERRORS_TEST_HPP__
+#define __ERRORS_TEST_HPP__
+
+// OnError::Stop and Collect. shared with the -fno-exceptions build in
+// test/noexcept, so nothing here may rely on exceptions
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+TEST(Errors, ConversionStopsChain) {
+    const char* argv[] = {"hello", "--count", "twelve", "-v", "in"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    int count = 7;
+    bool verbose = false;
+    std::string input;
+
+    cli::Parser parse(argc, argv);
+    parse
+        .on_error(cli::OnError::Stop)
+        .arg('n', "count", "test", count)
+        .flag('v', "verbose", "test", verbose)
+        .positional("input", "test", input);
+    parse.validate();
+
+    ASSERT_EQ(cli::ParseStatus::Error, parse.status());
+    EXPECT_EQ(cli::ErrorCode::InvalidInteger, parse.error().code);
+    EXPECT_EQ(2, parse.error().index);
+    EXPECT_EQ("invalid integer 'twelve'", parse.error().message());
+
+    // nothing after the failure ran
+    EXPECT_EQ(7, count);
+    EXPECT_FALSE(verbose);
+    EXPECT_EQ("", input);
+}
+
+TEST(Errors, Index) {
+    const char* argv[] = {"hello", "a", "--id=1", "--id=x", "--id", "y"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::vector<int> ids;
+
+    cli::Parser parse(argc, argv);
+    parse.on_error(cli::OnError::Stop).list("id", "test", ids);
+
+    ASSERT_TRUE(parse.failed());
+    EXPECT_EQ(3, parse.error().index);
+    EXPECT_STREQ("x", parse.error().value);
+    EXPECT_EQ((std::vector<int>{1}), ids);
+}
+
+TEST(Errors, Messages) {
+    struct Case {
+        std::vector<const char*> argv;
+        cli::ErrorCode code;
+        std::size_t index;
+        const char* message;
+    };
+    Case cases[] = {
+        {{"hello", "-n", "1", "-n", "2"}, cli::ErrorCode::Duplicate, 3,
+         "argument '-n/--count' cannot be provided multiple times"},
+        {{"hello", "-nn", "1"}, cli::ErrorCode::Run, 1, "argument 'n' cannot be given in a run"},
+        {{"hello", "--count"}, cli::ErrorCode::MissingValue, 1, "no argument value provided to '-n/--count'"},
+        {{"hello", "-v", "-v"}, cli::ErrorCode::DuplicateFlag, 2, "flag argument '-v/--verbose' provided more than once"},
+        {{"hello", "-n", "300"}, cli::ErrorCode::IntegerOutOfRange, 2, "integer '300' is out of range"},
+        {{"hello", "-n", "1"}, cli::ErrorCode::MissingArgument, cli::Error::npos, "missing argument: --input"},
+        {{"hello", "in", "--what", "x"}, cli::ErrorCode::Unused, 2, "unknown/unused argument(s): --what x"},
+    };
+
+    for (auto& c : cases) {
+        std::uint8_t count = 0;
+        bool verbose = false;
+        const char* input = nullptr;
+
+        cli::Parser parse(c.argv.size(), c.argv.data());
+        parse
+            .on_error(cli::OnError::Stop)
+            .flag('v', "verbose", "test", verbose)
+            .arg('n', "count", "test", count)
+            .positional("input", "test", input, cli::ArgReq::Required);
+        parse.validate();
+
+        ASSERT_TRUE(parse.failed()) << c.message;
+        EXPECT_EQ(c.code, parse.error().code) << c.message;
+        EXPECT_EQ(c.index, parse.error().index) << c.message;
+        EXPECT_EQ(c.message, parse.error().message());
+    }
+}
+
+TEST(Errors, Subcommand) {
+    const char* argv[] = {"hello", "--force", "run"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    bool run = false;
+    std::vector<std::string> rest;
+
+    cli::Parser parse(argc, argv);
+    parse.on_error(cli::OnError::Stop);
+    parse.subcommand("run", "test", run).done();
+    parse.all_positionals("rest", "test", rest);
+
+    ASSERT_TRUE(parse.failed());
+    EXPECT_EQ(cli::ErrorCode::NotAvailable, parse.error().code);
+    EXPECT_EQ(1, parse.error().index);
+    EXPECT_FALSE(run);
+    EXPECT_TRUE(rest.empty());
+}
+
+TEST(Errors, ResetClears) {
+    const char* bad[] = {"hello", "--count", "x"};
+    const char* good[] = {"hello", "--count", "3"};
+
+    int count = 0;
+    cli::Parser parse(3, bad);
+    parse.on_error(cli::OnError::Stop).arg("count", "test", count);
+    ASSERT_TRUE(parse.failed());
+
+    // the mode is kept
+    parse.reset(3, good).arg("count", "test", count);
+    EXPECT_EQ(cli::ParseStatus::Ok, parse.status());
+    EXPECT_EQ(3, count);
+
+    parse.reset(3, bad).arg("count", "test", count);
+    EXPECT_TRUE(parse.failed());
+}
+
+TEST(Errors, Sink) {
+    const char* argv[] = {"hello", "-w", "1.5", "-w", "1.5.2", "-w", "3"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    double sum = 0;
+    cli::Parser parse(argc, argv);
+    parse.on_error(cli::OnError::Stop).list('w', "test", cli::sink<double>([&](double w) { sum += w; }));
+
+    EXPECT_EQ(cli::ErrorCode::InvalidNumber, parse.error().code);
+    EXPECT_EQ(4, parse.error().index);
+    EXPECT_EQ(1.5, sum);
+}
+
+TEST(Errors, Parallel) {
+    std::vector<std::string> values;
+    std::vector<const char*> argv = {"hello"};
+    for (std::size_t i = 0; i < 20000; i++) {
+        values.push_back(std::to_string(i));
+    }
+    values[15000] = "oops";
+    for (auto& v : values) {
+        argv.push_back("-n");
+        argv.push_back(v.c_str());
+    }
+
+    std::vector<std::uint32_t> into;
+    cli::Parser parse(argv.size(), argv.data());
+    parse.on_error(cli::OnError::Stop).list('n', "test", cli::parallel(into, 4));
+
+    EXPECT_EQ(cli::ErrorCode::InvalidInteger, parse.error().code);
+    EXPECT_EQ(2 * 15000 + 2, parse.error().index);
+    EXPECT_EQ(15000, into.size());
+}
+
+struct ErrorsOptions {
+    int count = 0;
+    std::vector<const char*> rest;
+};
+
+TEST(Errors, Spec) {
+    const char* argv[] = {"hello", "a", "--count=z"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto spec = cli::Spec<ErrorsOptions>::Builder()
+        .on_error(cli::OnError::Stop)
+        .arg('n', "count", "test", &ErrorsOptions::count, "NUM")
+        .all_positionals("rest", "test", &ErrorsOptions::rest)
+        .compile();
+
+    ErrorsOptions opts;
+    cli::Spec<ErrorsOptions>::Scratch scratch;
+    ASSERT_EQ(cli::ParseStatus::Error, spec.parse(argc, argv, opts, scratch));
+    EXPECT_EQ(cli::ErrorCode::InvalidInteger, scratch.error().code);
+    EXPECT_EQ(2, scratch.error().index);
+    EXPECT_TRUE(opts.rest.empty());
+
+    const char* ok[] = {"hello", "a", "--count=2"};
+    EXPECT_EQ(cli::ParseStatus::Ok, spec.parse(3, ok, opts, scratch));
+    EXPECT_EQ(2, opts.count);
+}
+
+TEST(Errors, Suggestions) {
+    const char* argv[] = {"hello", "in", "--verbsoe", "--cuont=2", "-x", "--nothing-like-it"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    bool verbose = false;
+    int count = 0;
+    const char* input = nullptr;
+
+    cli::Parser parse(argc, argv);
+    parse
+        .on_error(cli::OnError::Stop)
+        .flag('v', "verbose", "test", verbose)
+        .arg('n', "count", "test", count)
+        .positional("input", "test", input);
+    parse.validate();
+
+    ASSERT_TRUE(parse.failed());
+    EXPECT_EQ(cli::ErrorCode::Unused, parse.error().code);
+    EXPECT_STREQ("verbose", parse.error().long_flag);
+    EXPECT_EQ(
+        "unknown/unused argument(s): --verbsoe (did you mean '--verbose'?)"
+        " --cuont=2 (did you mean '--count'?) -x --nothing-like-it",
+        parse.error().message()
+    );
+
+    // one entry per arg when collecting, only those near a name suggesting one
+    parse.reset(argc, argv)
+        .on_error(cli::OnError::Collect)
+        .flag('v', "verbose", "test", verbose)
+        .arg('n', "count", "test", count)
+        .positional("input", "test", input);
+    parse.validate();
+
+    auto& d = parse.diagnostics();
+    ASSERT_EQ(4, d.size());
+    EXPECT_STREQ("verbose", d[0].long_flag);
+    EXPECT_STREQ("count", d[1].long_flag);
+    EXPECT_EQ(nullptr, d[2].long_flag);
+    EXPECT_EQ(nullptr, d[3].long_flag);
+    EXPECT_EQ("unknown/unused argument(s): --cuont=2 (did you mean '--count'?)", d[1].message());
+}
+
+TEST(Errors, SubcommandSuggestions) {
+    const char* argv[] = {"hello", "remote", "remvoe"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    bool build = false;
+    const char* remote = nullptr;
+    const char* action = nullptr;
+
+    cli::Parser parse(argc, argv);
+    parse.on_error(cli::OnError::Stop)
+        .subcommand("build", "test", build).done()
+        .subcommand("remote", "test", remote)
+            .subcommand("add", "test", action).done()
+            .subcommand("remove", "test", action).done()
+            .done();
+    parse.validate();
+
+    ASSERT_TRUE(parse.failed());
+    EXPECT_EQ("unknown/unused argument(s): remvoe (did you mean 'remove'?)", parse.error().message());
+
+    // names from the level above are not suggested
+    const char* above[] = {"hello", "remote", "buidl"};
+    parse.reset(3, above)
+        .subcommand("build", "test", build).done()
+        .subcommand("remote", "test", remote)
+            .subcommand("add", "test", action).done()
+            .done();
+    parse.validate();
+
+    ASSERT_TRUE(parse.failed());
+    EXPECT_EQ(nullptr, parse.error().long_flag);
+}
+
+constexpr cli::SchemaOption ERRORS_SCHEMA_OPTS[] = {
+    {'v', "verbose", false},
+    {'n', "count", true},
+};
+CLIKIT_SCHEMA(ERRORS_SCHEMA, ERRORS_SCHEMA_OPTS);
+
+TEST(Errors, Schema) {
+    const char* argv[] = {"hello", "-v", "--verbose=yes"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::size_t seen = 0;
+    auto err = ERRORS_SCHEMA.try_scan(argc, argv, [&](std::size_t, const char*) { seen++; });
+
+    EXPECT_EQ(1, seen);
+    EXPECT_EQ(cli::ErrorCode::UnexpectedValue, err.code);
+    EXPECT_EQ(2, err.index);
+    EXPECT_EQ("argument '-v/--verbose' does not take a value", err.message());
+}
+
+TEST(Errors, Collect) {
+    const char* argv[] = {
+        "hello", "-v", "--count=x", "-vv", "-t", "1", "-t", "y", "--what", "-t", "3", "z", "--count", "2",
+    };
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    bool verbose = false;
+    int count = 0;
+    std::vector<int> tags;
+    const char* input = nullptr;
+    const char* output = nullptr;
+
+    cli::Parser parse(argc, argv);
+    parse
+        .on_error(cli::OnError::Collect)
+        .flag('v', "verbose", "test", verbose)
+        .arg('n', "count", "test", count)
+        .list('t', "tag", "test", tags)
+        .positional("input", "test", input)
+        .positional("output", "test", output, cli::ArgReq::Required);
+    parse.validate();
+
+    ASSERT_EQ(cli::ParseStatus::Error, parse.status());
+    auto& d = parse.diagnostics();
+    ASSERT_EQ(6, d.size());
+
+    EXPECT_EQ(cli::ErrorCode::DuplicateFlag, d[0].code);
+    EXPECT_EQ(3, d[0].index);
+    EXPECT_EQ(cli::ErrorCode::InvalidInteger, d[1].code);
+    EXPECT_EQ(2, d[1].index);
+    EXPECT_EQ(cli::ErrorCode::Duplicate, d[2].code);
+    EXPECT_EQ(12, d[2].index);
+    EXPECT_EQ(cli::ErrorCode::InvalidInteger, d[3].code);
+    EXPECT_EQ(7, d[3].index);
+    EXPECT_EQ(cli::ErrorCode::MissingArgument, d[4].code);
+    EXPECT_EQ(cli::Error::npos, d[4].index);
+    EXPECT_EQ(cli::ErrorCode::Unused, d[5].code);
+    EXPECT_EQ(8, d[5].index);
+
+    // the first is also the error
+    EXPECT_EQ(d[0].code, parse.error().code);
+
+    // parsing carried on past each
+    EXPECT_TRUE(verbose);
+    EXPECT_EQ((std::vector<int>{1, 3}), tags);
+    EXPECT_STREQ("z", input);
+
+    std::stringstream ss;
+    d.print(ss);
+    EXPECT_EQ(
+        "flag argument '-v/--verbose' provided more than once\n"
+        "invalid integer 'x'\n"
+        "argument '-n/--count' cannot be provided multiple times\n"
+        "invalid integer 'y'\n"
+        "missing argument: --output\n"
+        "unknown/unused argument(s): --what\n",
+        ss.str()
+    );
+
+    // nothing to report
+    const char* good[] = {"hello", "a", "b"};
+    parse.reset(3, good)
+        .positional("input", "test", input)
+        .positional("output", "test", output);
+    parse.validate();
+    EXPECT_EQ(cli::ParseStatus::Ok, parse.status());
+    EXPECT_TRUE(parse.diagnostics().empty());
+}
+
+TEST(Errors, ConversionIndex) {
+    // a value is reported where it is: the next arg, or the arg with the '='
+    const char* argv[] = {"hello", "-t", "a", "--tag=b", "-n", "c"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::vector<int> tags;
+    int count = 0;
+
+    cli::Parser parse(argc, argv);
+    parse
+        .on_error(cli::OnError::Collect)
+        .list('t', "tag", "test", tags)
+        .arg('n', "count", "test", count);
+
+    auto& d = parse.diagnostics();
+    ASSERT_EQ(3, d.size());
+    EXPECT_EQ(2, d[0].index);
+    EXPECT_EQ(3, d[1].index);
+    EXPECT_EQ(5, d[2].index);
+}
+
+TEST(Errors, CollectSubcommand) {
+    const char* argv[] = {"hello", "--force", "run", "x", "-q"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    bool run = false;
+    std::vector<std::string> rest;
+
+    cli::Parser parse(argc, argv);
+    parse.on_error(cli::OnError::Collect);
+    parse.subcommand("run", "test", run).done();
+    parse.all_positionals("rest", "test", rest);
+
+    auto& d = parse.diagnostics();
+    ASSERT_EQ(2, d.size());
+    EXPECT_EQ(cli::ErrorCode::NotAvailable, d[0].code);
+    EXPECT_EQ(1, d[0].index);
+    EXPECT_EQ(cli::ErrorCode::UnknownArgument, d[1].code);
+    EXPECT_EQ(4, d[1].index);
+    EXPECT_TRUE(run);
+    EXPECT_EQ((std::vector<std::string>{"x"}), rest);
+}
+
+TEST(Errors, CollectSpec) {
+    const char* argv[] = {"hello", "--count=z", "a", "--count=1", "-x"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto spec = cli::Spec<ErrorsOptions>::Builder()
+        .on_error(cli::OnError::Collect)
+        .arg('n', "count", "test", &ErrorsOptions::count, "NUM")
+        .all_positionals("rest", "test", &ErrorsOptions::rest)
+        .compile();
+
+    ErrorsOptions opts;
+    cli::Spec<ErrorsOptions>::Scratch scratch;
+    ASSERT_EQ(cli::ParseStatus::Error, spec.parse(argc, argv, opts, scratch));
+
+    auto& d = scratch.diagnostics();
+    ASSERT_EQ(3, d.size());
+    EXPECT_EQ(cli::ErrorCode::InvalidInteger, d[0].code);
+    EXPECT_EQ(cli::ErrorCode::Duplicate, d[1].code);
+    EXPECT_EQ(cli::ErrorCode::UnknownArgument, d[2].code);
+    EXPECT_EQ(4, d[2].index);
+    EXPECT_EQ((std::vector<const char*>{argv[2]}), opts.rest);
+}
+
+#endif
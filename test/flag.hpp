@@ -48,6 +48,43 @@ TEST(Flag, Invert) {
     EXPECT_EQ(inv, false);
 }
 
+TEST(Flag, AbbreviatedLong) {
+    const char* argv[] = {"hello", "--verb", "--q"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    bool verbose = false;
+    bool quiet = false;
+
+    cli::Parser parse(argc, argv);
+    parse.flag('v', "verbose", "test", verbose)
+         .flag('q', "quiet", "test", quiet);
+
+    EXPECT_TRUE(verbose);
+    EXPECT_TRUE(quiet);
+    EXPECT_EQ(0, parse.gather_remaining().size());
+}
+
+TEST(Flag, SharedRun) {
+    const char* argv[] = {"hello", "-vxq"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    bool v = false;
+    bool x = false;
+    bool q = false;
+
+    cli::Parser parse(argc, argv);
+    parse.flag('v', "test", v)
+         .flag('x', "test", x);
+
+    EXPECT_TRUE(v);
+    EXPECT_TRUE(x);
+    EXPECT_THROW(parse.validate(), cli::ParseError);
+
+    parse.flag('q', "test", q);
+    EXPECT_TRUE(q);
+    EXPECT_NO_THROW(parse.validate());
+}
+
 
 //-------------------------------------------------------------------------
 // error tests
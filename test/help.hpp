@@ -31,6 +31,74 @@ TEST(Help, TriggeredLong) {
     EXPECT_TRUE(parse.wants_help());
 }
 
+TEST(Help, Render) {
+    const char* argv[] = {"tool", "--help"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    bool verbose = false;
+    const char* output = nullptr;
+    std::size_t jobs = 0;
+    const char* input = nullptr;
+    std::vector<const char*> rest;
+
+    cli::Parser parse(argc, argv);
+    parse.details("tool", "does things", "A longer description.")
+        .version("v1.2")
+        .flag('v', "verbose", "more output", verbose)
+        .arg('o', "output", "where to write", output, "FILE", cli::ArgReq::Required)
+        .arg("jobs", "parallel jobs", jobs, "N")
+        .positional("input", "the input", input, cli::ArgReq::Required)
+        .all_positionals("rest", "everything else", rest);
+
+    const char* expected =
+        "tool v1.2 - does things\n"
+        "\n"
+        "usage: tool [-vo --jobs] input [rest...]\n"
+        "\n"
+        "A longer description.\n"
+        "\n"
+        "options:\n"
+        "    -v/--verbose        more output\n"
+        "    -o/--output FILE    where to write\n"
+        "       --jobs N         parallel jobs\n"
+        "\n"
+        "positionals:\n"
+        "    input               the input\n"
+        "    rest...             [optional] everything else\n"
+        "\n"
+        "\n";
+
+    // print() is a single write(2) to stdout
+    testing::internal::CaptureStdout();
+    parse.print();
+    EXPECT_EQ(expected, testing::internal::GetCapturedStdout());
+}
+
+TEST(Help, InternsText) {
+    cli::HelpMap help;
+    help.details("tool", "");
+    help.new_group("group", "");
+    for (int i = 0; i < 1000; i++) {
+        auto name = "opt-" + std::to_string(i);
+        help.add_arg(i % 2, 0, name.c_str(), "FILE", "shared description");
+    }
+
+    // every option shares one copy of its arg name and description
+    auto& grouped = help._groups.back().second;
+    ASSERT_EQ(500u, grouped.size());
+    ASSERT_EQ(500u, help._args.size());
+    EXPECT_EQ(grouped[0].desc.offset, help._args[0].desc.offset);
+    EXPECT_EQ(grouped[0].arg_name.offset, help._args.back().arg_name.offset);
+    EXPECT_LT(help._strings.size(), 1000u * 20);
+
+    auto flags = help._args.back().flags;
+    EXPECT_EQ("   --opt-998", std::string(help.text(flags), flags.len));
+    auto l = help._args.back().long_flag();
+    EXPECT_EQ("opt-998", std::string(help.text(l), l.len));
+
+    // widest left column: indent + "   --opt-999 FILE" (grouped)
+    EXPECT_EQ(4u + 17u, help._longest_flag);
+}
 
 //-------------------------------------------------------------------------
 // error testing
@@ -0,0 +1,77 @@
+#ifndef __INDEX_TEST_HPP__
+#define __INDEX_TEST_HPP__
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+// builds an ArgIndex over `argv` (no program name) and finds `s`/`l` in it
+class IndexTest {
+public:
+    std::vector<const char*> argv;
+    cli::ArgTable args;
+    cli::ArgIndex index;
+
+    void build(std::vector<const char*> a) {
+        argv = std::move(a);
+        cli::classify_args(argv.size(), argv.data(), 'h', "help", args);
+        index.build(argv.size(), argv.data(), args);
+    }
+
+    std::vector<std::size_t> find(char s, const char* l) {
+        cli::ArenaVector<std::size_t> out;
+        index.find(argv.data(), args, s, l, out);
+        return std::vector<std::size_t>(out.begin(), out.end());
+    }
+};
+
+TEST(Index, Prefixes) {
+    IndexTest t;
+    t.build({"--verb", "--verbose", "--v", "--vx", "-v", "--verbosity", "--verbose=1", "verbose"});
+
+    // every arg whose name is a prefix of the long, and the short, in argv order
+    EXPECT_EQ((std::vector<std::size_t>{0, 1, 2, 4, 6}), t.find('v', "verbose"));
+    EXPECT_EQ((std::vector<std::size_t>{0, 2, 5}), t.find(0, "verbosity"));
+    EXPECT_EQ((std::vector<std::size_t>{2, 3}), t.find(0, "vx"));
+    EXPECT_EQ((std::vector<std::size_t>{4}), t.find('v', nullptr));
+    EXPECT_TRUE(t.find(0, "quiet").empty());
+}
+
+TEST(Index, DuplicateNamesGrouped) {
+    IndexTest t;
+    t.build({"--a", "--b", "--a=1", "--ab", "-a", "--a", "--b=2"});
+
+    // repeats of a name stay in argv order, and merge with other groups
+    EXPECT_EQ((std::vector<std::size_t>{0, 2, 5}), t.find(0, "a"));
+    EXPECT_EQ((std::vector<std::size_t>{0, 2, 3, 5}), t.find(0, "ab"));
+    EXPECT_EQ((std::vector<std::size_t>{0, 2, 3, 4, 5}), t.find('a', "ab"));
+    EXPECT_EQ((std::vector<std::size_t>{1, 6}), t.find(0, "b"));
+}
+
+TEST(Index, ManyNames) {
+    // enough distinct names to grow the table several times, all the same
+    // length so that none is a prefix of another
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < 500; i++) { names.push_back("--name-" + std::to_string(1000 + i)); }
+
+    std::vector<const char*> argv;
+    for (auto& n : names) { argv.push_back(n.c_str()); }
+    for (auto& n : names) { argv.push_back(n.c_str()); }
+
+    IndexTest t;
+    t.build(argv);
+    for (std::size_t i = 0; i < names.size(); i++) {
+        EXPECT_EQ((std::vector<std::size_t>{i, i + names.size()}), t.find(0, names[i].c_str() + 2)) << names[i];
+    }
+    EXPECT_TRUE(t.find(0, "name-").empty());
+
+    // rebuilding forgets the names of the last build
+    t.build({"--other", "--name-1007"});
+    EXPECT_EQ((std::vector<std::size_t>{1}), t.find(0, "name-1007"));
+    EXPECT_TRUE(t.find(0, "name-1008").empty());
+    EXPECT_EQ((std::vector<std::size_t>{0}), t.find(0, "other"));
+}
+
+#endif
@@ -33,6 +33,35 @@ TEST(List, Longs) {
     EXPECT_EQ(counts[1], 456);
     EXPECT_EQ(counts[2], 98);
 }
+TEST(List, MixedShortAndLongInOrder) {
+    const char* argv[] = {"hello", "--file", "a", "-f", "b", "--fi=c", "-f=d"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::vector<std::string> files;
+
+    cli::Parser parse(argc, argv);
+    parse.list('f', "file", "test", files);
+
+    ASSERT_EQ(4, files.size());
+    EXPECT_EQ("a", files[0]);
+    EXPECT_EQ("b", files[1]);
+    EXPECT_EQ("c", files[2]);
+    EXPECT_EQ("d", files[3]);
+}
+
+TEST(List, EqValueIsNotARun) {
+    const char* argv[] = {"hello", "-f=ff.c"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::vector<std::string> files;
+
+    cli::Parser parse(argc, argv);
+    parse.list('f', "file", "test", files);
+
+    ASSERT_EQ(1, files.size());
+    EXPECT_EQ("ff.c", files[0]);
+}
+
 
 //-------------------------------------------------------------------------
 // error testing
@@ -1,9 +1,24 @@
 #include "gtest/gtest.h"
 
+#include "test/allocator.hpp"
 #include "test/arg.hpp"
+#include "test/bitset.hpp"
+#include "test/classify.hpp"
+#include "test/complete.hpp"
+#include "test/convert.hpp"
 #include "test/count.hpp"
+#include "test/embed.hpp"
+#include "test/errors.hpp"
 #include "test/flag.hpp"
 #include "test/help.hpp"
+#include "test/index.hpp"
 #include "test/list.hpp"
+#include "test/parallel.hpp"
 #include "test/positional.hpp"
+#include "test/response.hpp"
+#include "test/schema.hpp"
+#include "test/sink.hpp"
+#include "test/spec.hpp"
 #include "test/subcommand.hpp"
+#include "test/suggest.hpp"
+#include "test/view.hpp"
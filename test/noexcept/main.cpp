@@ -0,0 +1,25 @@
+// built with -fno-exceptions, where parsers always stop at the first error
+
+#include "gtest/gtest.h"
+
+#include "test/errors.hpp"
+
+TEST(NoExcept, DefaultsToStop) {
+    const char* argv[] = {"hello", "--count", "x"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    int count = 0;
+    cli::Parser parse(argc, argv);
+    parse.on_error(cli::OnError::Throw).arg("count", "test", count);
+
+    EXPECT_EQ(cli::ParseStatus::Error, parse.status());
+    EXPECT_EQ(cli::ErrorCode::InvalidInteger, parse.error().code);
+}
+
+TEST(NoExcept, BitSetBounds) {
+    cli::BitSet set(10);
+    EXPECT_EQ(cli::BitSet::npos, set.set(10));
+    EXPECT_FALSE(set.is_set(10));
+    EXPECT_EQ(3, set.set(3));
+    EXPECT_TRUE(set.is_set(3));
+}
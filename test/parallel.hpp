@@ -0,0 +1,107 @@
+#ifndef __PARALLEL_TEST_HPP__
+#define __PARALLEL_TEST_HPP__
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+// enough values that every thread gets a slice
+static const std::size_t PARALLEL_TEST_VALUES = 4 * cli::PARALLEL_CONVERT_PER_THREAD + 17;
+
+struct ParallelArgs {
+    std::vector<std::string> storage;
+    std::vector<const char*> argv = {"hello", "-v"};
+
+    // "--id N" for N in [0, n), with the text of each (index, text) in
+    // `bad` replaced. argv points into storage, so it is built after all
+    ParallelArgs(std::size_t n, std::vector<std::pair<std::size_t, const char*>> bad = {}) {
+        storage.reserve(n);
+        for (std::size_t i = 0; i < n; i++) {
+            storage.push_back(std::to_string(i));
+        }
+        for (auto& b : bad) {
+            storage[b.first] = b.second;
+        }
+        for (auto& s : storage) {
+            argv.push_back("--id");
+            argv.push_back(s.c_str());
+        }
+    }
+};
+
+TEST(Parallel, MatchesSequential) {
+    ParallelArgs args(PARALLEL_TEST_VALUES);
+
+    bool verbose = false;
+    std::vector<std::uint64_t> ids = {42};
+    std::vector<std::string> names;
+
+    cli::Parser parse(args.argv.size(), args.argv.data());
+    parse.flag('v', "verbose", "test", verbose)
+         .list("id", "test", cli::parallel(ids, 4));
+    parse.validate();
+
+    // appended after what was already there, in argv order
+    ASSERT_EQ(PARALLEL_TEST_VALUES + 1, ids.size());
+    EXPECT_EQ(42, ids[0]);
+    for (std::size_t i = 0; i < PARALLEL_TEST_VALUES; i++) {
+        ASSERT_EQ(i, ids[i + 1]);
+    }
+    EXPECT_TRUE(verbose);
+
+    cli::Parser strings(args.argv.size(), args.argv.data());
+    strings.list('i', "id", "test", cli::parallel(names, 3));
+    ASSERT_EQ(PARALLEL_TEST_VALUES, names.size());
+    EXPECT_EQ(args.storage, names);
+}
+
+TEST(Parallel, Deque) {
+    ParallelArgs args(100);
+
+    std::deque<double> values;
+
+    cli::Parser parse(args.argv.size(), args.argv.data());
+    parse.list("id", "test", cli::parallel(values));
+
+    ASSERT_EQ(100, values.size());
+    EXPECT_EQ(99.0, values.back());
+}
+
+
+//-------------------------------------------------------------------------
+// error testing
+//-------------------------------------------------------------------------
+
+TEST(Parallel, FirstErrorWins) {
+    // one bad value near the end of the first slice, another in the last
+    auto first = cli::PARALLEL_CONVERT_PER_THREAD - 1;
+    ParallelArgs args(PARALLEL_TEST_VALUES, {{first, "nope"}, {PARALLEL_TEST_VALUES - 1, "-1"}});
+
+    std::vector<std::uint32_t> ids;
+
+    cli::Parser parse(args.argv.size(), args.argv.data());
+    try {
+        parse.list("id", "test", cli::parallel(ids, 4));
+        FAIL() << "expected a ParseError";
+    } catch (cli::ParseError& e) {
+        EXPECT_STREQ("invalid integer 'nope'", e.what());
+    }
+
+    // only the values before the failure are kept
+    ASSERT_EQ(first, ids.size());
+    EXPECT_EQ(first - 1, ids.back());
+
+    // reported at the bad value, past the program name, "-v" and its "--id"
+    ids.clear();
+    parse.reset(args.argv.size(), args.argv.data())
+        .on_error(cli::OnError::Stop)
+        .list("id", "test", cli::parallel(ids, 4));
+    ASSERT_TRUE(parse.failed());
+    EXPECT_EQ(2 * first + 3, parse.error().index);
+}
+
+#endif
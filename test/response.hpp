@@ -0,0 +1,296 @@
+#ifndef __RESPONSE_TEST_HPP__
+#define __RESPONSE_TEST_HPP__
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+#include "test/spec.hpp"
+
+// a response file that is removed when the test ends
+class ResponseFile {
+protected:
+    std::string _arg;
+
+public:
+    ResponseFile(const std::string& name, const std::string& contents) {
+        auto dir = getenv("TEST_TMPDIR");
+        _arg = std::string("@") + (dir ? dir : "/tmp") + "/clikit_" + name;
+        write(contents);
+    }
+    ~ResponseFile() { remove(path()); }
+
+    void write(const std::string& contents) {
+        auto f = fopen(path(), "wb");
+        fwrite(contents.data(), 1, contents.size(), f);
+        fclose(f);
+    }
+
+    const char* path() const { return _arg.c_str() + 1; }
+    const char* arg() const { return _arg.c_str(); }
+};
+
+TEST(Response, Expands) {
+    ResponseFile file("expands", "-v --name 'hello world'\n\t\"say \\\"hi\\\"\" pos\\ one ''");
+    const char* argv[] = {"hello", "first", file.arg(), "--count", "3"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    bool verbose = false;
+    std::string name;
+    std::size_t count = 0;
+    std::vector<std::string> rest;
+
+    cli::Parser parse(argc, argv);
+    parse.expand_response_files()
+         .flag('v', "verbose", "test", verbose)
+         .arg('n', "name", "test", name)
+         .arg('c', "count", "test", count)
+         .all_positionals("rest", "test", rest);
+    parse.validate();
+
+    EXPECT_TRUE(verbose);
+    EXPECT_EQ("hello world", name);
+    EXPECT_EQ(3, count);
+    ASSERT_EQ(4, rest.size());
+    EXPECT_EQ("first", rest[0]);
+    EXPECT_EQ("say \"hi\"", rest[1]);
+    EXPECT_EQ("pos one", rest[2]);
+    EXPECT_EQ("", rest[3]);
+}
+
+TEST(Response, OptIn) {
+    ResponseFile file("opt_in", "-v");
+    const char* argv[] = {"hello", file.arg()};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    bool verbose = false;
+    const char* pos = nullptr;
+
+    cli::Parser parse(argc, argv);
+    parse.flag('v', "verbose", "test", verbose)
+         .positional("pos", "test", pos);
+
+    EXPECT_FALSE(verbose);
+    EXPECT_STREQ(file.arg(), pos);
+}
+
+TEST(Response, DetectsHelp) {
+    ResponseFile file("help", "-v --help");
+    const char* argv[] = {"hello", file.arg()};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    bool verbose = false;
+
+    cli::Parser parse(argc, argv);
+    EXPECT_FALSE(parse.wants_help());
+    parse.expand_response_files()
+         .flag('v', "verbose", "test", verbose);
+
+    EXPECT_TRUE(parse.wants_help());
+    EXPECT_NO_THROW(parse.validate());
+}
+
+TEST(Response, Nested) {
+    ResponseFile inner("nested_inner", "--name inner");
+    ResponseFile outer("nested_outer", std::string("-v ") + inner.arg());
+    const char* argv[] = {"hello", outer.arg()};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    bool verbose = false;
+    std::string name;
+
+    cli::Parser parse(argc, argv);
+    parse.expand_response_files()
+         .flag('v', "verbose", "test", verbose)
+         .arg('n', "name", "test", name);
+    parse.validate();
+
+    EXPECT_TRUE(verbose);
+    EXPECT_EQ("inner", name);
+}
+
+TEST(Response, TokenEndsOnPageBoundary) {
+    // no room after the last token for its terminator
+    auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    std::string contents = "--name ";
+    contents += std::string(page - contents.size(), 'x');
+    ResponseFile file("page", contents);
+    const char* argv[] = {"hello", file.arg()};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::string name;
+
+    cli::Parser parse(argc, argv);
+    parse.expand_response_files()
+         .arg('n', "name", "test", name);
+
+    EXPECT_EQ(page - 7, name.size());
+}
+
+TEST(Response, ManyEntries) {
+    std::string contents;
+    for (std::size_t i = 0; i < 100000; i++) {
+        contents += "--id " + std::to_string(i) + "\n";
+    }
+    ResponseFile file("many", contents);
+    const char* argv[] = {"hello", file.arg()};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::vector<std::uint64_t> ids;
+
+    cli::Parser parse(argc, argv);
+    parse.expand_response_files()
+         .list("id", "test", ids);
+    parse.validate();
+
+    ASSERT_EQ(100000, ids.size());
+    EXPECT_EQ(0, ids.front());
+    EXPECT_EQ(99999, ids.back());
+}
+
+TEST(Response, Spec) {
+    ResponseFile file("spec", "-v -lll in");
+    const char* argv[] = {"hello", file.arg(), "--count=4"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto spec = cli::Spec<SpecOptions>::Builder()
+        .response_files()
+        .flag('v', "verbose", "test", &SpecOptions::verbose)
+        .count('l', "level", "test", &SpecOptions::level)
+        .arg('n', "count", "test", &SpecOptions::count, "NUM")
+        .positional("input", "test", &SpecOptions::input)
+        .compile();
+
+    // the scratch owns the mapping `input` points into
+    SpecOptions opts;
+    cli::Spec<SpecOptions>::Scratch scratch;
+    EXPECT_EQ(cli::ParseStatus::Ok, spec.parse(argc, argv, opts, scratch));
+    EXPECT_TRUE(opts.verbose);
+    EXPECT_EQ(3, opts.level);
+    EXPECT_EQ(4, opts.count);
+    EXPECT_STREQ("in", opts.input);
+}
+
+// whether `file` is mapped into this process, where that can be told
+static bool response_mapped(const ResponseFile& file) {
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    while (std::getline(maps, line)) {
+        if (line.find(file.path()) != std::string::npos) { return true; }
+    }
+    return false;
+}
+
+TEST(Response, BorrowsFromParser) {
+    ResponseFile file("borrows_from_parser", "--name kept pos");
+    const char* argv[] = {"hello", file.arg()};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    const char* name = nullptr;
+    const char* pos = nullptr;
+    {
+        cli::Parser parse(argc, argv);
+        parse.expand_response_files()
+             .arg('n', "name", "test", name, "NAME")
+             .positional("pos", "test", pos);
+        parse.validate();
+
+        // valid while the parser holds the mapping
+        EXPECT_STREQ("kept", name);
+        EXPECT_STREQ("pos", pos);
+#ifdef __linux__
+        EXPECT_TRUE(response_mapped(file));
+#endif
+
+        // and released when it moves on to the next argv
+        const char* other[] = {"hello", "--name", "x"};
+        parse.reset(3, other);
+#ifdef __linux__
+        EXPECT_FALSE(response_mapped(file));
+#endif
+
+        // or with the parser
+        parse.reset(argc, argv).expand_response_files();
+#ifdef __linux__
+        EXPECT_TRUE(response_mapped(file));
+#endif
+    }
+#ifdef __linux__
+    EXPECT_FALSE(response_mapped(file));
+#endif
+}
+
+TEST(Response, SpecNeedsScratch) {
+    ResponseFile file("spec_needs_scratch", "-v in");
+    const char* argv[] = {"hello", file.arg()};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto spec = cli::Spec<SpecOptions>::Builder()
+        .response_files()
+        .flag('v', "verbose", "test", &SpecOptions::verbose)
+        .positional("input", "test", &SpecOptions::input)
+        .compile();
+
+    // nothing would own the mapping past parse()
+    SpecOptions opts;
+    EXPECT_THROW(spec.parse(argc, argv, opts), cli::InternalError);
+    EXPECT_FALSE(opts.verbose);
+
+    // the scratch holds it until its next parse
+    cli::Spec<SpecOptions>::Scratch scratch;
+    EXPECT_EQ(cli::ParseStatus::Ok, spec.parse(argc, argv, opts, scratch));
+    EXPECT_STREQ("in", opts.input);
+#ifdef __linux__
+    EXPECT_TRUE(response_mapped(file));
+#endif
+
+    const char* other[] = {"hello", "out"};
+    EXPECT_EQ(cli::ParseStatus::Ok, spec.parse(2, other, opts, scratch));
+    EXPECT_STREQ("out", opts.input);
+#ifdef __linux__
+    EXPECT_FALSE(response_mapped(file));
+#endif
+}
+
+
+//-------------------------------------------------------------------------
+// error testing
+//-------------------------------------------------------------------------
+
+TEST(Response, UnusedTokensReported) {
+    ResponseFile file("unused", "--bogus");
+    const char* argv[] = {"hello", file.arg()};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    cli::Parser parse(argc, argv);
+    parse.expand_response_files();
+    try {
+        parse.validate();
+        FAIL() << "expected a ParseError";
+    } catch (cli::ParseError& e) {
+        EXPECT_STREQ("unknown/unused argument(s): --bogus", e.what());
+    }
+}
+
+TEST(Response, Errors) {
+    ResponseFile cycle("cycle", "");
+    cycle.write(cycle.arg());
+    ResponseFile quote("quote", "--name 'oops");
+
+    const char* missing[] = {"hello", "@/nonexistent/clikit_response"};
+    const char* nested[] = {"hello", cycle.arg()};
+    const char* unterminated[] = {"hello", quote.arg()};
+
+    cli::Parser a(2, missing);
+    EXPECT_THROW(a.expand_response_files(), cli::ParseError);
+    cli::Parser b(2, nested);
+    EXPECT_THROW(b.expand_response_files(), cli::ParseError);
+    cli::Parser c(2, unterminated);
+    EXPECT_THROW(c.expand_response_files(), cli::ParseError);
+}
+
+#endif
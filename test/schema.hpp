@@ -0,0 +1,97 @@
+#ifndef __SCHEMA_TEST_HPP__
+#define __SCHEMA_TEST_HPP__
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+constexpr cli::SchemaOption SCHEMA_TEST_OPTS[] = {
+    {'v', "verbose", false},
+    {'n', "count", true},
+    {'f', "file", true},
+    {0, "dry-run", false},
+    {'x', nullptr, false},
+};
+CLIKIT_SCHEMA(SCHEMA_TEST, SCHEMA_TEST_OPTS);
+
+// lookups are usable at compile time
+static_assert(SCHEMA_TEST.find_long("verbose") == 0, "long lookup");
+static_assert(SCHEMA_TEST.find_long("dry-run") == 3, "long only lookup");
+static_assert(SCHEMA_TEST.find_long("verb") == SCHEMA_TEST.npos, "no abbreviations");
+static_assert(SCHEMA_TEST.find_short('x') == 4, "short only lookup");
+static_assert(SCHEMA_TEST.find_short('q') == SCHEMA_TEST.npos, "short miss");
+
+constexpr cli::SchemaOption SCHEMA_DUP_OPTS[] = {
+    {'v', "verbose", false},
+    {'v', "version", false},
+    {'q', "verbose", false},
+};
+constexpr auto SCHEMA_DUP = cli::make_schema(SCHEMA_DUP_OPTS);
+static_assert(SCHEMA_DUP.duplicate_short() == 'v', "duplicate short detected");
+static_assert(SCHEMA_DUP.duplicate_long() == 2, "duplicate long detected");
+
+TEST(Schema, LargeSetIsPerfect) {
+    static const std::size_t N = 300;
+    static std::string names[N];
+    cli::SchemaOption opts[N] = {};
+    for (std::size_t i = 0; i < N; i++) {
+        names[i] = "option-" + std::to_string(i);
+        opts[i] = {0, names[i].c_str(), false};
+    }
+
+    cli::Schema<N> schema(opts);
+    ASSERT_TRUE(schema.hashed());
+    for (std::size_t i = 0; i < N; i++) {
+        EXPECT_EQ(i, schema.find_long(names[i].c_str()));
+    }
+    EXPECT_EQ(schema.npos, schema.find_long("option-"));
+}
+
+TEST(Schema, Scan) {
+    const char* argv[] = {"hello", "-vx", "in", "--count=3", "-f", "a", "--dry-run", "--nope", "-"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::vector<std::pair<std::size_t, std::string>> seen;
+    SCHEMA_TEST.scan(argc, argv, [&](std::size_t id, const char* value) {
+        seen.emplace_back(id, value ? value : "");
+    });
+
+    using P = std::pair<std::size_t, std::string>;
+    std::vector<P> expected = {
+        P(0, ""),
+        P(4, ""),
+        P(SCHEMA_TEST.positional, "in"),
+        P(1, "3"),
+        P(2, "a"),
+        P(3, ""),
+        P(SCHEMA_TEST.unknown, "--nope"),
+        P(SCHEMA_TEST.positional, "-"),
+    };
+    EXPECT_EQ(expected, seen);
+}
+
+
+//-------------------------------------------------------------------------
+// error testing
+//-------------------------------------------------------------------------
+
+TEST(Schema, ValueInRun) {
+    const char* argv[] = {"hello", "-vn", "3"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    EXPECT_THROW(
+        SCHEMA_TEST.scan(argc, argv, [](std::size_t, const char*) {}),
+        cli::ParseError
+    );
+}
+
+TEST(Schema, MissingValue) {
+    const char* argv[] = {"hello", "--count"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    EXPECT_THROW(
+        SCHEMA_TEST.scan(argc, argv, [](std::size_t, const char*) {}),
+        cli::ParseError
+    );
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef __SINK_TEST_HPP__
+#define __SINK_TEST_HPP__
+
+#include <iterator>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+TEST(Sink, Callable) {
+    const char* argv[] = {"hello", "--id", "3", "-i", "1", "--id=2"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::vector<std::uint64_t> seen;
+    std::uint64_t sum = 0;
+
+    cli::Parser parse(argc, argv);
+    parse.list('i', "id", "test", cli::sink<std::uint64_t>([&](std::uint64_t id) {
+        seen.push_back(id);
+        sum += id;
+    }));
+    parse.validate();
+
+    // argv order, not grouped by short/long
+    EXPECT_EQ((std::vector<std::uint64_t>{3, 1, 2}), seen);
+    EXPECT_EQ(6, sum);
+}
+
+TEST(Sink, OutputIterator) {
+    const char* argv[] = {"hello", "-w", "0.5", "-w", "2"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::stringstream ss;
+
+    cli::Parser parse(argc, argv);
+    parse.list('w', "test", cli::sink<double>(std::ostream_iterator<double>(ss, ",")));
+    parse.validate();
+
+    EXPECT_EQ("0.5,2,", ss.str());
+}
+
+TEST(Sink, Lvalue) {
+    const char* argv[] = {"hello", "--name", "a", "--name", "b"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::string buffer[4];
+    auto into = cli::sink<std::string>(buffer);
+
+    cli::Parser parse(argc, argv);
+    parse.list("name", "test", into);
+
+    EXPECT_EQ(buffer + 2, into.consumer());
+    EXPECT_EQ("a", buffer[0]);
+    EXPECT_EQ("b", buffer[1]);
+}
+
+TEST(Sink, AllPositionals) {
+    const char* argv[] = {"hello", "-v", "x", "y", "z"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    bool verbose = false;
+    std::string joined;
+
+    cli::Parser parse(argc, argv);
+    parse.flag('v', "verbose", "test", verbose)
+         .all_positionals("files", "test", cli::sink<const char*>([&](const char* f) {
+             joined += f;
+         }));
+
+    EXPECT_TRUE(verbose);
+    EXPECT_EQ("xyz", joined);
+}
+
+
+//-------------------------------------------------------------------------
+// error testing
+//-------------------------------------------------------------------------
+
+TEST(Sink, ConversionError) {
+    const char* argv[] = {"hello", "-n", "1", "-n", "two", "-n", "3"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::vector<int> seen;
+
+    cli::Parser parse(argc, argv);
+    EXPECT_THROW(
+        parse.list('n', "test", cli::sink<int>(std::back_inserter(seen))),
+        cli::ParseError
+    );
+
+    // values before the bad one were already delivered
+    EXPECT_EQ(std::vector<int>{1}, seen);
+}
+
+#endif
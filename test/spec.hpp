@@ -0,0 +1,109 @@
+#ifndef __SPEC_TEST_HPP__
+#define __SPEC_TEST_HPP__
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+struct SpecOptions {
+    bool verbose = false;
+    std::size_t level = 0;
+    std::size_t count = 0;
+    std::vector<std::string> files;
+    const char* input = nullptr;
+    std::vector<const char*> rest;
+};
+
+static cli::Spec<SpecOptions> spec_test_spec() {
+    return cli::Spec<SpecOptions>::Builder()
+        .details("hello", "just a hello world tool we can use")
+        .flag('v', "verbose", "test", &SpecOptions::verbose)
+        .count('l', "level", "test", &SpecOptions::level)
+        .arg('n', "count", "test", &SpecOptions::count, "NUM")
+        .list('f', "file", "test", &SpecOptions::files, "FILE")
+        .positional("input", "test", &SpecOptions::input, cli::ArgReq::Required)
+        .all_positionals("rest", "test", &SpecOptions::rest)
+        .compile();
+}
+
+TEST(Spec, MatchesParser) {
+    const char* argv[] = {"hello", "-v", "in", "-lll", "--count=12", "-f", "a", "--file", "b", "x", "y"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto spec = spec_test_spec();
+
+    SpecOptions opts;
+    ASSERT_EQ(cli::ParseStatus::Ok, spec.parse(argc, argv, opts));
+
+    EXPECT_TRUE(opts.verbose);
+    EXPECT_EQ(3, opts.level);
+    EXPECT_EQ(12, opts.count);
+    ASSERT_EQ(2, opts.files.size());
+    EXPECT_EQ("a", opts.files[0]);
+    EXPECT_EQ("b", opts.files[1]);
+    EXPECT_STREQ("in", opts.input);
+    ASSERT_EQ(2, opts.rest.size());
+    EXPECT_STREQ("x", opts.rest[0]);
+    EXPECT_STREQ("y", opts.rest[1]);
+}
+
+TEST(Spec, ReuseScratch) {
+    const char* first[] = {"hello", "-n", "1", "one"};
+    const char* second[] = {"hello", "two", "-v"};
+
+    auto spec = spec_test_spec();
+    cli::Spec<SpecOptions>::Scratch scratch;
+
+    SpecOptions a;
+    spec.parse(sizeof(first) / sizeof(first[0]), first, a, scratch);
+    SpecOptions b;
+    spec.parse(sizeof(second) / sizeof(second[0]), second, b, scratch);
+
+    EXPECT_EQ(1, a.count);
+    EXPECT_FALSE(a.verbose);
+    EXPECT_STREQ("one", a.input);
+
+    EXPECT_EQ(0, b.count);
+    EXPECT_TRUE(b.verbose);
+    EXPECT_STREQ("two", b.input);
+}
+
+TEST(Spec, Help) {
+    const char* argv[] = {"hello", "--help"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto spec = spec_test_spec();
+
+    SpecOptions opts;
+    EXPECT_EQ(cli::ParseStatus::Help, spec.parse(argc, argv, opts));
+
+    std::stringstream ss;
+    spec.print(ss);
+    EXPECT_NE(std::string::npos, ss.str().find("-f/--file FILE"));
+}
+
+
+//-------------------------------------------------------------------------
+// error testing
+//-------------------------------------------------------------------------
+
+TEST(Spec, MissingRequired) {
+    const char* argv[] = {"hello", "-v"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto spec = spec_test_spec();
+
+    SpecOptions opts;
+    EXPECT_THROW(spec.parse(argc, argv, opts), cli::MissingArgumentError);
+}
+
+TEST(Spec, Unused) {
+    const char* argv[] = {"hello", "in", "--nope"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    auto spec = spec_test_spec();
+
+    SpecOptions opts;
+    EXPECT_THROW(spec.parse(argc, argv, opts), cli::ParseError);
+}
+
+#endif
@@ -223,6 +223,189 @@ TEST(Subcommand, ToList) {
     EXPECT_EQ("clean", subcommands[2]);
 }
 
+//
+// tables
+//
+
+static constexpr cli::SubcommandDesc SUBCOMMAND_TEST_TOP[] = {
+    {"build", "build subcommand"},
+    {"test", "test subcommand"},
+    {"remote", "remote subcommand"},
+};
+CLIKIT_SUBCOMMANDS(SUBCOMMAND_TEST_COMMANDS, SUBCOMMAND_TEST_TOP);
+
+static constexpr cli::SubcommandDesc SUBCOMMAND_TEST_REMOTE[] = {
+    {"add", "adds a remote"},
+    {"remove", "removes a remote"},
+};
+CLIKIT_SUBCOMMANDS(SUBCOMMAND_TEST_REMOTES, SUBCOMMAND_TEST_REMOTE);
+
+static_assert(SUBCOMMAND_TEST_COMMANDS.find("remote") == 2, "");
+static_assert(SUBCOMMAND_TEST_COMMANDS.find("remot") == SUBCOMMAND_TEST_COMMANDS.npos, "");
+
+// parses `argv` through the tables, giving the ids entered ("-" if none)
+static std::string subcommand_test_tables(std::vector<const char*> argv, bool& verbose) {
+    std::size_t cmd = SUBCOMMAND_TEST_COMMANDS.npos;
+    std::size_t remote = SUBCOMMAND_TEST_REMOTES.npos;
+    std::string name;
+
+    cli::Parser parse(argv.size(), argv.data());
+    parse.subcommand(SUBCOMMAND_TEST_COMMANDS, cmd);
+    if (cmd == 2) {
+        parse.subcommand(SUBCOMMAND_TEST_REMOTES, remote)
+            .positional("name", "remote name", name)
+            .done();
+    } else if (cmd == 0) {
+        parse.flag('v', "verbose", "build verbosity", verbose);
+    }
+    parse.done();
+    parse.validate();
+
+    auto id = [](std::size_t i) { return (i == cli::Subcommands<1>::npos) ? std::string("-") : std::to_string(i); };
+    return id(cmd) + " " + id(remote) + " " + name;
+}
+
+TEST(Subcommand, Table) {
+    bool verbose = false;
+    EXPECT_EQ("0 - ", subcommand_test_tables({"hello", "build", "-v"}, verbose));
+    EXPECT_TRUE(verbose);
+
+    verbose = false;
+    EXPECT_EQ("2 1 origin", subcommand_test_tables({"hello", "remote", "remove", "origin"}, verbose));
+    EXPECT_EQ("1 - ", subcommand_test_tables({"hello", "test"}, verbose));
+    EXPECT_FALSE(verbose);
+
+    // prefixes are not subcommands
+    EXPECT_THROW(subcommand_test_tables({"hello", "bui"}, verbose), cli::ParseError);
+
+    // options for the subcommand must come after it
+    EXPECT_THROW(subcommand_test_tables({"hello", "-v", "build"}, verbose), cli::ParseError);
+}
+
+TEST(Subcommand, TableHelp) {
+    const char* argv[] = {"hello", "remote", "--help"};
+    std::size_t cmd = SUBCOMMAND_TEST_COMMANDS.npos;
+    std::size_t remote = SUBCOMMAND_TEST_REMOTES.npos;
+
+    cli::Parser parse(3, argv);
+    parse.dynamic_help().subcommand(SUBCOMMAND_TEST_COMMANDS, cmd);
+    if (cmd == 2) {
+        parse.subcommand(SUBCOMMAND_TEST_REMOTES, remote).done();
+    }
+    parse.done();
+
+    ASSERT_TRUE(parse.wants_help());
+    EXPECT_EQ(2u, cmd);
+    EXPECT_EQ(SUBCOMMAND_TEST_REMOTES.npos, remote);
+
+    testing::internal::CaptureStdout();
+    parse.print();
+    auto help = testing::internal::GetCapturedStdout();
+    EXPECT_NE(std::string::npos, help.find("adds a remote"));
+    EXPECT_NE(std::string::npos, help.find("removes a remote"));
+    EXPECT_EQ(std::string::npos, help.find("build subcommand"));
+}
+
+TEST(Subcommand, TableDuplicates) {
+    constexpr cli::SubcommandDesc subs[] = {{"a", ""}, {"b", ""}, {"a", ""}};
+    constexpr auto table = cli::make_subcommands(subs);
+    static_assert(table.duplicate() == 2, "");
+    EXPECT_EQ(0u, table.find("a"));
+    EXPECT_EQ(1u, table.find("b"));
+}
+
+//
+// lazy bodies
+//
+
+TEST(Subcommand, Lazy) {
+    const char* argv[] = {"hello", "remote", "add", "-f", "origin"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    const char* cmd = nullptr;
+    const char* remote_cmd = nullptr;
+    std::size_t build_calls = 0;
+    std::size_t remote_calls = 0;
+    bool fetch = false;
+    std::string name;
+
+    cli::Parser parse(argc, argv);
+    parse.subcommand("build", "build subcommand", cmd, [&](cli::Parser&) {
+            build_calls++;
+        })
+        .subcommand("remote", "remote subcommand", cmd, [&](cli::Parser& p) {
+            remote_calls++;
+            p.subcommand("add", "adds a remote", remote_cmd, [&](cli::Parser& p) {
+                    p.flag('f', "fetch", "fetch after adding", fetch)
+                        .positional("name", "remote name", name);
+                })
+                .subcommand("remove", "removes a remote", remote_cmd, [&](cli::Parser&) {
+                    EXPECT_FALSE(true) << "called the body of an unmatched subcommand";
+                });
+        })
+        .subcommand("test", "test subcommand", cmd, [&](cli::Parser&) {
+            EXPECT_FALSE(true) << "called the body of an unmatched subcommand";
+        });
+    parse.validate();
+
+    EXPECT_EQ(0u, build_calls);
+    EXPECT_EQ(1u, remote_calls);
+    EXPECT_STREQ("remote", cmd);
+    EXPECT_STREQ("add", remote_cmd);
+    EXPECT_TRUE(fetch);
+    EXPECT_EQ("origin", name);
+}
+
+TEST(Subcommand, LazyHelp) {
+    const char* argv[] = {"hello", "remote", "--help"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    const char* cmd = nullptr;
+    const char* remote_cmd = nullptr;
+    std::size_t remote_calls = 0;
+
+    cli::Parser parse(argc, argv);
+    parse.dynamic_help()
+        .subcommand("build", "build subcommand", cmd, [&](cli::Parser&) {
+            EXPECT_FALSE(true) << "called the body of an unmatched subcommand";
+        })
+        .subcommand("remote", "remote subcommand", cmd, [&](cli::Parser& p) {
+            remote_calls++;
+            p.subcommand("add", "adds a remote", remote_cmd, [&](cli::Parser&) {
+                    EXPECT_FALSE(true) << "called the body of an unmatched subcommand";
+                })
+                .subcommand("remove", "removes a remote", remote_cmd, [&](cli::Parser&) {
+                    EXPECT_FALSE(true) << "called the body of an unmatched subcommand";
+                });
+        });
+
+    ASSERT_TRUE(parse.wants_help());
+    EXPECT_EQ(1u, remote_calls);
+
+    testing::internal::CaptureStdout();
+    parse.print();
+    auto help = testing::internal::GetCapturedStdout();
+    EXPECT_NE(std::string::npos, help.find("adds a remote"));
+    EXPECT_NE(std::string::npos, help.find("removes a remote"));
+    EXPECT_EQ(std::string::npos, help.find("build subcommand"));
+}
+
+TEST(Subcommand, LazyTable) {
+    const char* argv[] = {"hello", "build", "-v"};
+    std::size_t cmd = SUBCOMMAND_TEST_COMMANDS.npos;
+    bool verbose = false;
+
+    cli::Parser parse(3, argv);
+    parse.subcommand(SUBCOMMAND_TEST_COMMANDS, cmd, [&](cli::Parser& p, std::size_t id) {
+        EXPECT_EQ(0u, id);
+        p.flag('v', "verbose", "build verbosity", verbose);
+    });
+    parse.validate();
+
+    EXPECT_EQ(0u, cmd);
+    EXPECT_TRUE(verbose);
+}
+
 //-------------------------------------------------------------------------
 // error testing
 //-------------------------------------------------------------------------
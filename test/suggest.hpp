@@ -0,0 +1,143 @@
+#ifndef __SUGGEST_TEST_HPP__
+#define __SUGGEST_TEST_HPP__
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+// optimal string alignment distance, the slow way
+static std::size_t suggest_test_distance(const std::string& a, const std::string& b) {
+    std::vector<std::vector<std::size_t>> d(a.size() + 1, std::vector<std::size_t>(b.size() + 1));
+    for (std::size_t i = 0; i <= a.size(); i++) { d[i][0] = i; }
+    for (std::size_t j = 0; j <= b.size(); j++) { d[0][j] = j; }
+
+    for (std::size_t i = 1; i <= a.size(); i++) {
+        for (std::size_t j = 1; j <= b.size(); j++) {
+            std::size_t cost = (a[i-1] == b[j-1]) ? 0 : 1;
+            d[i][j] = std::min({d[i-1][j] + 1, d[i][j-1] + 1, d[i-1][j-1] + cost});
+            if ((i > 1) and (j > 1) and (a[i-1] == b[j-2]) and (a[i-2] == b[j-1])) {
+                d[i][j] = std::min(d[i][j], d[i-2][j-2] + 1);
+            }
+        }
+    }
+    return d[a.size()][b.size()];
+}
+
+TEST(Suggest, Distance) {
+    struct Case {
+        const char* name;
+        const char* candidate;
+        std::size_t distance;
+    };
+    Case cases[] = {
+        {"verbose", "verbose", 0},
+        {"verbos", "verbose", 1},
+        {"vrebose", "verbose", 1},
+        {"verbsoe", "verbose", 1},
+        {"vebrose", "verbose", 1},
+        {"hepl", "help", 1},
+    };
+    for (auto& c : cases) {
+        cli::NearestName nearest(c.name, strlen(c.name));
+        EXPECT_EQ(c.distance, nearest.distance(c.candidate, strlen(c.candidate))) << c.name;
+    }
+
+    // anything past the bound is reported as just past it
+    cli::NearestName nearest("output", 6);
+    EXPECT_EQ(2, nearest.bound());
+    EXPECT_EQ(3, nearest.distance("verbose", 7));
+}
+
+TEST(Suggest, MatchesDynamicProgramming) {
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> len(0, 70);
+    std::uniform_int_distribution<int> letter('a', 'd');
+
+    auto random_name = [&] {
+        std::string s(len(rng), 'a');
+        for (auto& c : s) { c = static_cast<char>(letter(rng)); }
+        return s;
+    };
+
+    for (std::size_t i = 0; i < 5000; i++) {
+        auto a = random_name();
+        auto b = a;
+        // mostly near misses, which are what suggestions are made from
+        if (i % 4) {
+            std::uniform_int_distribution<int> edits(0, 4);
+            for (int e = edits(rng); e > 0 and not b.empty(); e--) {
+                std::uniform_int_distribution<std::size_t> at(0, b.size() - 1);
+                auto p = at(rng);
+                switch (e % 4) {
+                case 0: b.erase(p, 1); break;
+                case 1: b.insert(p, 1, static_cast<char>(letter(rng))); break;
+                case 2: b[p] = static_cast<char>(letter(rng)); break;
+                case 3: if (p + 1 < b.size()) { std::swap(b[p], b[p + 1]); } break;
+                }
+            }
+        } else {
+            b = random_name();
+        }
+
+        cli::NearestName nearest(a.data(), a.size());
+        auto expected = suggest_test_distance(a, b);
+        auto got = nearest.distance(b.data(), b.size());
+        if (a.empty() or (a.size() > cli::NearestName::MAX_LEN) or (expected > nearest.bound())) {
+            EXPECT_EQ(nearest.bound() + 1, got) << a << " / " << b;
+        } else {
+            EXPECT_EQ(expected, got) << a << " / " << b;
+        }
+    }
+}
+
+TEST(Suggest, Nearest) {
+    cli::NearestName nearest("outptu", 6);
+    nearest.consider("input");
+    nearest.consider("outputs");
+    nearest.consider("output");
+    nearest.consider("outptu");
+    EXPECT_STREQ("output", nearest.best());
+
+    cli::NearestName none("zzzzzz", 6);
+    none.consider("output");
+    EXPECT_EQ(nullptr, none.best());
+}
+
+TEST(Suggest, Thrown) {
+    const char* argv[] = {"hello", "--hepl"};
+    bool verbose = false;
+
+    cli::Parser parse(2, argv);
+    parse.flag('v', "verbose", "test", verbose);
+    try {
+        parse.validate();
+        EXPECT_FALSE(true) << "did not throw for an unknown argument";
+    } catch (const cli::ParseError& err) {
+        EXPECT_STREQ("unknown/unused argument(s): --hepl (did you mean '--help'?)", err.what());
+    }
+}
+
+TEST(Suggest, Table) {
+    static constexpr cli::SubcommandDesc subs[] = {
+        {"checkout", "test"},
+        {"commit", "test"},
+        {"cherry-pick", "test"},
+    };
+    CLIKIT_SUBCOMMANDS(commands, subs);
+
+    const char* argv[] = {"hello", "comit"};
+    std::size_t cmd = commands.npos;
+
+    cli::Parser parse(2, argv);
+    parse.on_error(cli::OnError::Stop).subcommand(commands, cmd).done();
+    parse.validate();
+
+    ASSERT_TRUE(parse.failed());
+    EXPECT_STREQ("commit", parse.error().long_flag);
+}
+
+#endif
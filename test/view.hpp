@@ -0,0 +1,112 @@
+#ifndef __VIEW_TEST_HPP__
+#define __VIEW_TEST_HPP__
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/clikit.hpp"
+
+TEST(View, ArgPointsIntoArgv) {
+    const char* argv[] = {"hello", "--name=value", "-o", "out", "--empty="};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    cli::StringView name;
+    cli::StringView out;
+    cli::StringView empty;
+
+    cli::Parser parse(argc, argv);
+    parse.arg("name", "test", name, "NAME")
+        .arg('o', "test", out, "FILE")
+        .arg("empty", "test", empty, "E")
+        .validate();
+    ASSERT_FALSE(parse.failed());
+
+    // past the '=', with no copy
+    EXPECT_EQ(argv[1] + 7, name.data());
+    EXPECT_EQ(5, name.size());
+    EXPECT_EQ(cli::StringView("value"), name);
+
+    EXPECT_EQ(argv[3], out.data());
+    EXPECT_EQ(3, out.size());
+
+    EXPECT_EQ(argv[4] + 8, empty.data());
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST(View, PositionalsAndLists) {
+    const char* argv[] = {"hello", "first", "-i", "a", "--include=bc", "second", "third"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::vector<cli::StringView> includes;
+    cli::StringView first;
+    std::vector<cli::StringView> rest;
+
+    cli::Parser parse(argc, argv);
+    parse.list('i', "include", "test", includes)
+        .positional("first", "test", first)
+        .all_positionals("rest", "test", rest);
+    ASSERT_FALSE(parse.failed());
+
+    ASSERT_EQ(2, includes.size());
+    EXPECT_EQ(argv[3], includes[0].data());
+    EXPECT_EQ(argv[4] + 10, includes[1].data());
+    EXPECT_EQ(2, includes[1].size());
+
+    EXPECT_EQ(argv[1], first.data());
+    EXPECT_EQ(5, first.size());
+
+    ASSERT_EQ(2, rest.size());
+    EXPECT_EQ(argv[5], rest[0].data());
+    EXPECT_EQ(argv[6], rest[1].data());
+    EXPECT_EQ(5, rest[1].size());
+}
+
+TEST(View, SinkAndSpec) {
+    const char* argv[] = {"hello", "-t=x", "-t", "yz", "input"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::vector<cli::StringView> tags;
+    cli::Parser parse(argc, argv);
+    parse.list('t', "test", cli::sink<cli::StringView>([&](cli::StringView t) {
+        tags.push_back(t);
+    }));
+    ASSERT_EQ(2, tags.size());
+    EXPECT_EQ(argv[1] + 3, tags[0].data());
+    EXPECT_EQ(argv[3], tags[1].data());
+
+    struct Options {
+        std::vector<cli::StringView> tags;
+        cli::StringView input;
+    };
+    auto spec = cli::Spec<Options>::Builder()
+        .list('t', "tag", "test", &Options::tags, "TAG")
+        .positional("input", "test", &Options::input)
+        .compile();
+
+    Options opts;
+    ASSERT_EQ(cli::ParseStatus::Ok, spec.parse(argc, argv, opts));
+    ASSERT_EQ(2, opts.tags.size());
+    EXPECT_EQ(argv[1] + 3, opts.tags[0].data());
+    EXPECT_EQ(1, opts.tags[0].size());
+    EXPECT_EQ(argv[4], opts.input.data());
+    EXPECT_EQ(5, opts.input.size());
+}
+
+#if __cplusplus >= 201703L
+TEST(View, StdStringView) {
+    const char* argv[] = {"hello", "--name=value", "input"};
+    std::size_t argc = sizeof(argv) / sizeof(argv[0]);
+
+    std::string_view name;
+    std::string_view input;
+    cli::Parser parse(argc, argv);
+    parse.arg("name", "test", name, "NAME")
+        .positional("input", "test", input);
+
+    EXPECT_EQ(argv[1] + 7, name.data());
+    EXPECT_EQ("value", name);
+    EXPECT_EQ(argv[2], input.data());
+}
+#endif
+
+#endif
@@ -0,0 +1,59 @@
+"""Build rules for programs parsing their arguments with clikit."""
+
+def clikit_binary(name, srcs = [], deps = [], help_flag = "--help", **kwargs):
+    """A cc_binary whose help text is rendered at build time.
+
+    The program is first built as `<name>_help_gen` and run with
+    `help_flag` for every subcommand path it registers. The help it prints
+    is embedded into `<name>` as read-only data, so at runtime
+    Parser::print() writes the block for the matched subcommand path
+    without recording the chain into a HelpMap.
+
+    The generator runs with CLIKIT_EMBED_HELP set to the exact value of
+    cli::EMBED_HELP_VALUE, which makes Parser::print() write a record of
+    the help and subcommands for tools/embed_help instead of the help
+    itself. The variable is ignored at runtime with any other value.
+
+    The program must call Parser::print() and exit 0 when given
+    `help_flag`. Parsers registering options at runtime should call
+    Parser::dynamic_help(), which ignores the embedded help.
+
+    Args:
+      name: the binary
+      srcs: as for cc_binary
+      deps: as for cc_binary, including clikit
+      help_flag: the long help flag the program's Parser uses
+      **kwargs: passed to both cc_binary rules
+    """
+    gen = name + "_help_gen"
+    native.cc_binary(
+        name = gen,
+        srcs = srcs,
+        deps = deps,
+        **kwargs
+    )
+
+    native.genrule(
+        name = name + "_help_src",
+        outs = [name + "_help.cpp"],
+        tools = [
+            ":" + gen,
+            "//tools:embed_help",
+        ],
+        cmd = "$(location //tools:embed_help) $(location :%s) %s > $@" % (gen, help_flag),
+    )
+
+    native.cc_library(
+        name = name + "_help",
+        srcs = [name + "_help.cpp"],
+        deps = ["//src:clikit"],
+        # only referenced through its static initializer
+        alwayslink = True,
+    )
+
+    native.cc_binary(
+        name = name,
+        srcs = srcs,
+        deps = deps + [":" + name + "_help"],
+        **kwargs
+    )
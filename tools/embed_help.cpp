@@ -0,0 +1,196 @@
+// Renders the help of a clikit program for every subcommand path and
+// writes it out as C++ source that embeds it (see cli::embed_help).
+//
+//     embed_help PROGRAM [HELP_FLAG] > help.cpp
+//
+// PROGRAM is run once per path as "PROGRAM [subcommand...] HELP_FLAG"
+// (HELP_FLAG defaults to --help) with CLIKIT_EMBED_HELP set to
+// cli::EMBED_HELP_VALUE, which makes Parser::print() report the
+// subcommands it knows of along with the help and the completion spec.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <errno.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "src/clikit.hpp"
+
+// subcommands nested deeper than this are assumed to be a cycle
+static const std::size_t MAX_DEPTH = 16;
+
+struct Entry {
+    std::string path; // as HelpMap::subcommand_path()
+    std::string text;
+    std::string complete; // as HelpMap::completions()
+};
+
+[[noreturn]] static void die(const std::string& msg) {
+    std::cerr << "embed_help: " << msg << std::endl;
+    exit(1);
+}
+
+// runs the program for `subs`, returning what it wrote to stdout
+static std::string run(const char* program, const char* help_flag, const std::vector<std::string>& subs) {
+    int fds[2];
+    if (pipe(fds) != 0) { die(std::string("pipe: ") + strerror(errno)); }
+
+    auto pid = fork();
+    if (pid < 0) { die(std::string("fork: ") + strerror(errno)); }
+    if (pid == 0) {
+        std::vector<const char*> argv = {program};
+        for (auto& s : subs) { argv.push_back(s.c_str()); }
+        argv.push_back(help_flag);
+        argv.push_back(nullptr);
+
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        setenv(cli::EMBED_HELP_ENV, cli::EMBED_HELP_VALUE, 1);
+        execv(program, const_cast<char* const*>(argv.data()));
+        _exit(127);
+    }
+
+    close(fds[1]);
+    std::string out;
+    char buf[4096];
+    while (true) {
+        auto n = read(fds[0], buf, sizeof(buf));
+        if (n < 0 and errno == EINTR) { continue; }
+        if (n <= 0) { break; }
+        out.append(buf, n);
+    }
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (not WIFEXITED(status) or (WEXITSTATUS(status) != 0)) {
+        die(std::string("running ") + program + " for help failed");
+    }
+    return out;
+}
+
+// reads a size, a newline and that many bytes of the record
+static void read_block(std::istream& in, std::string& out) {
+    std::size_t size = 0;
+    if (not (in >> size)) { die("truncated help record"); }
+    in.ignore(1);
+    out.resize(size);
+    if (size and not in.read(&out[0], size)) { die("truncated help record"); }
+}
+
+// splits the record written by Parser::print() into subcommands, help and
+// completion spec
+static void read_record(const std::string& record, std::vector<std::string>& subs, Entry& entry) {
+    std::istringstream in(record);
+    std::size_t count = 0;
+    if (not (in >> count)) { die("no help record, does the program call Parser::print()?"); }
+    in.ignore(1);
+
+    for (std::size_t i = 0; i < count; i++) {
+        std::string sub;
+        std::getline(in, sub);
+        subs.push_back(sub);
+    }
+
+    read_block(in, entry.text);
+    read_block(in, entry.complete);
+}
+
+static void collect(
+    const char* program, const char* help_flag,
+    std::vector<std::string>& subs, std::vector<Entry>& out
+) {
+    if (subs.size() > MAX_DEPTH) { die("subcommands nest too deeply"); }
+
+    std::vector<std::string> children;
+    Entry entry;
+    read_record(run(program, help_flag, subs), children, entry);
+    for (auto& s : subs) { entry.path += " " + s; }
+    out.push_back(std::move(entry));
+
+    for (auto& child : children) {
+        subs.push_back(child);
+        collect(program, help_flag, subs, out);
+        subs.pop_back();
+    }
+}
+
+// a C string literal of `s`, split after each newline
+static void literal(std::ostream& os, const std::string& s) {
+    os << "\"";
+    for (std::size_t i = 0; i < s.size(); i++) {
+        auto c = static_cast<unsigned char>(s[i]);
+        switch (c) {
+        case '\n':
+            os << "\\n";
+            if (i + 1 < s.size()) { os << "\"\n    \""; }
+            break;
+        case '\t': os << "\\t"; break;
+        case '"': os << "\\\""; break;
+        case '\\': os << "\\\\"; break;
+        case '?': os << "\\?"; break; // no trigraphs
+        default:
+            if ((c < 0x20) or (c >= 0x7f)) {
+                char oct[8];
+                snprintf(oct, sizeof(oct), "\\%03o", c);
+                os << oct;
+            } else {
+                os << c;
+            }
+        }
+    }
+    os << "\"";
+}
+
+int main(int argc, const char** argv) {
+    if ((argc < 2) or (argc > 3)) {
+        std::cerr << "usage: embed_help PROGRAM [HELP_FLAG] > help.cpp" << std::endl;
+        return 2;
+    }
+    const char* program = argv[1];
+    const char* help_flag = (argc == 3) ? argv[2] : "--help";
+
+    std::vector<std::string> subs;
+    std::vector<Entry> entries;
+    collect(program, help_flag, subs, entries);
+
+    // find_embedded_help() binary searches by path
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return strcmp(a.path.c_str(), b.path.c_str()) < 0;
+    });
+
+    std::ostringstream os;
+    os << "// generated by embed_help, do not edit\n\n";
+    os << "#include \"src/clikit.hpp\"\n\n";
+    os << "namespace {\n\n";
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        os << "const char HELP_" << i << "[] =\n    ";
+        literal(os, entries[i].text);
+        os << ";\n\n";
+        os << "const char COMPLETE_" << i << "[] =\n    ";
+        literal(os, entries[i].complete);
+        os << ";\n\n";
+    }
+    os << "const cli::EmbeddedHelp TABLE[] = {\n";
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        os << "    {";
+        literal(os, entries[i].path);
+        os << ", HELP_" << i << ", sizeof(HELP_" << i << ") - 1";
+        os << ", COMPLETE_" << i << ", sizeof(COMPLETE_" << i << ") - 1},\n";
+    }
+    os << "};\n\n";
+    os << "const bool embedded = cli::embed_help(TABLE, sizeof(TABLE) / sizeof(TABLE[0]));\n\n";
+    os << "} // ns\n";
+
+    auto text = os.str();
+    std::cout.write(text.data(), text.size());
+    return std::cout.good() ? 0 : 1;
+}